@@ -0,0 +1,240 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Measurement harness shared by the kernel benchmarks.
+  On target the time base is the DWT cycle counter. Cores or emulators without
+  a working DWT (QEMU does not model CYCCNT) fall back to SysTick, which also
+  counts CPU cycles but only resolves the time between two ticks, so the tick
+  number is kept by a SysTick hook. On the host port the time base is the
+  nanosecond clock of the port.
+*/
+#include "Bench.h"
+#include "Tasks.h"
+
+#if defined(OS_PORT_POSIX)
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#define BENCH_LINE_SIZE    256
+
+#if !defined(OS_PORT_POSIX)
+static uint8_t UseSysTick;               // DWT->CYCCNT does not run, use SysTick instead
+static volatile uint32_t SysTickCount;   // Ticks elapsed since Bench_Init (SysTick time base only)
+
+/* Counts the ticks for the SysTick time base */
+static void Bench_SysTickHook(void) {
+    SysTickCount++;
+}
+#endif
+
+/**
+ * @brief Selects the time base. Must be called before OS_StartOS.
+ */
+void Bench_Init(void) {
+#if !defined(OS_PORT_POSIX)
+    uint32_t Start;
+
+    OS_CYCLE_COUNTER_INIT();
+    Start = DWT->CYCCNT;
+    for (volatile uint8_t i = 0; i < 10; i++) {
+    }
+    if (DWT->CYCCNT == Start) {
+        UseSysTick = 1;
+        OS_RegisterSysTickHook(Bench_SysTickHook);
+    }
+#endif
+}
+
+/**
+ * @brief Reads the free running time base.
+ *
+ * @return uint32_t Current time in the unit returned by Bench_Unit().
+ */
+uint32_t Bench_Now(void) {
+#if defined(OS_PORT_POSIX)
+    return OS_GET_CYCLE_COUNT();
+#else
+    uint32_t Ticks;
+    uint32_t Value;
+
+    if (!UseSysTick) {
+        return DWT->CYCCNT;
+    }
+
+    // Retry if a tick was accounted between both reads
+    do {
+        Ticks = SysTickCount;
+        Value = SysTick->VAL;
+    } while (Ticks != SysTickCount);
+
+    return (Ticks * (SysTick->LOAD + 1)) + (SysTick->LOAD - Value);
+#endif
+}
+
+/**
+ * @brief Returns the unit of the time base.
+ */
+const char* Bench_Unit(void) {
+#if defined(OS_PORT_POSIX)
+    return "ns";
+#else
+    return UseSysTick ? "systick_cycles" : "cycles";
+#endif
+}
+
+/**
+ * @brief Clears a result before collecting samples.
+ *
+ * @param Result Pointer to the result.
+ * @param Name Name of the measured operation.
+ */
+void Bench_ResultInit(Bench_Result* Result, const char* Name) {
+    Bench_ResultInitUnit(Result, Name, NULL);
+}
+
+/**
+ * @brief Clears a result whose samples are not durations (counts, bytes, ...).
+ *
+ * @param Result Pointer to the result.
+ * @param Name Name of the measured quantity.
+ * @param Unit Unit reported in the output, NULL for the time base.
+ */
+void Bench_ResultInitUnit(Bench_Result* Result, const char* Name, const char* Unit) {
+    Result->Name = Name;
+    Result->Unit = Unit;
+    Result->Count = 0;
+    Result->Min = 0xFFFFFFFF;
+    Result->Max = 0;
+    Result->Sum = 0;
+    for (uint8_t i = 0; i < BENCH_HISTOGRAM_BINS; i++) {
+        Result->Histogram[i] = 0;
+    }
+}
+
+/**
+ * @brief Adds one sample to a result.
+ *
+ * @param Result Pointer to the result.
+ * @param Sample Measured duration (or value, in the unit of the result).
+ */
+void Bench_Record(Bench_Result* Result, uint32_t Sample) {
+    uint32_t Bin = 0;
+
+    if (Sample != 0) {
+        Bin = 32 - OS_COUNT_LEADING_ZEROS(Sample);
+        if (Bin >= BENCH_HISTOGRAM_BINS) {
+            Bin = BENCH_HISTOGRAM_BINS - 1;
+        }
+    }
+
+    Result->Count++;
+    Result->Sum += Sample;
+    Result->Histogram[Bin]++;
+    if (Sample < Result->Min) {
+        Result->Min = Sample;
+    }
+    if (Sample > Result->Max) {
+        Result->Max = Sample;
+    }
+}
+
+/* Appends a string to the output line */
+static char* Bench_PutString(char* Out, const char* String) {
+    while (*String) {
+        *Out++ = *String++;
+    }
+    return Out;
+}
+
+/* Appends an unsigned decimal number to the output line */
+static char* Bench_PutNumber(char* Out, uint32_t Number) {
+    char Digits[10];
+    uint8_t Length = 0;
+
+    do {
+        Digits[Length++] = (char)('0' + (Number % 10));
+        Number /= 10;
+    } while (Number != 0);
+
+    while (Length) {
+        *Out++ = Digits[--Length];
+    }
+    return Out;
+}
+
+/* Writes a null terminated string to the output channel */
+static void Bench_Write(const char* String) {
+#if defined(OS_PORT_POSIX)
+    fputs(String, stdout);
+#elif BENCH_SEMIHOSTING
+    // SYS_WRITE0
+    __asm volatile ("MOV R0, #0x04 \n\t"
+                    "MOV R1, %0 \n\t"
+                    "BKPT 0xAB"
+                    : : "r" (String) : "r0", "r1", "memory");
+#else
+    (void)String;
+#endif
+}
+
+/**
+ * @brief Emits a result as one JSON line:
+ * {"bench":"name","unit":"cycles","n":1000,"min":1,"avg":2,"max":3,"hist_log2":[...]}
+ *
+ * @param Result Pointer to the result.
+ */
+void Bench_Report(const Bench_Result* Result) {
+    char Line[BENCH_LINE_SIZE];
+    char* Out = Line;
+    uint32_t Average = Result->Count ? (uint32_t)(Result->Sum / Result->Count) : 0;
+
+    Out = Bench_PutString(Out, "{\"bench\":\"");
+    Out = Bench_PutString(Out, Result->Name);
+    Out = Bench_PutString(Out, "\",\"unit\":\"");
+    Out = Bench_PutString(Out, Result->Unit ? Result->Unit : Bench_Unit());
+    Out = Bench_PutString(Out, "\",\"n\":");
+    Out = Bench_PutNumber(Out, Result->Count);
+    Out = Bench_PutString(Out, ",\"min\":");
+    Out = Bench_PutNumber(Out, Result->Count ? Result->Min : 0);
+    Out = Bench_PutString(Out, ",\"avg\":");
+    Out = Bench_PutNumber(Out, Average);
+    Out = Bench_PutString(Out, ",\"max\":");
+    Out = Bench_PutNumber(Out, Result->Max);
+    Out = Bench_PutString(Out, ",\"hist_log2\":[");
+    for (uint8_t i = 0; i < BENCH_HISTOGRAM_BINS; i++) {
+        if (i) {
+            *Out++ = ',';
+        }
+        Out = Bench_PutNumber(Out, Result->Histogram[i]);
+    }
+    Out = Bench_PutString(Out, "]}\n");
+    *Out = '\0';
+
+    Bench_Write(Line);
+}
+
+/**
+ * @brief Ends the benchmark run (exits QEMU or the host process).
+ */
+void Bench_Finish(void) {
+#if defined(OS_PORT_POSIX)
+    fflush(stdout);
+    exit(0);
+#else
+#if BENCH_SEMIHOSTING
+    // SYS_EXIT with ADP_Stopped_ApplicationExit
+    __asm volatile ("MOV R0, #0x18 \n\t"
+                    "LDR R1, =0x20026 \n\t"
+                    "BKPT 0xAB"
+                    : : : "r0", "r1", "memory");
+#endif
+    while (1) {
+    }
+#endif
+}
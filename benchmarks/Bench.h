@@ -0,0 +1,58 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Measurement harness shared by the kernel benchmarks. Samples are kept as
+  min/avg/max plus a log2 histogram and reported as one JSON object per line,
+  so results can be collected by a script and compared between commits.
+*/
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include "Config.h"
+#include "Port.h"
+
+#if !defined(OS_PORT_POSIX) && !OS_PRIVILEGED_TASKS
+#error "The benchmarks read DWT/SysTick from tasks: set OS_PRIVILEGED_TASKS in Config.h"
+#endif
+
+#if OS_TICKLESS_IDLE_ENABLED
+#error "The benchmarks need the periodic tick: clear OS_TICKLESS_IDLE_ENABLED in Config.h"
+#endif
+
+// Report through ARM semihosting (QEMU -semihosting or a debugger). When 0 the
+// results are only left in memory and the benchmark ends in an endless loop.
+#ifndef BENCH_SEMIHOSTING
+#define BENCH_SEMIHOSTING             1
+#endif
+
+// Number of log2 histogram bins: bin 0 holds 0, bin k holds [2^(k-1), 2^k), the last bin the rest
+#define BENCH_HISTOGRAM_BINS          16
+
+/** Statistics of one measured operation */
+typedef struct {
+    const char* Name;                         // Name reported in the output
+    const char* Unit;                         // Unit of the samples, NULL for the time base
+    uint32_t Count;                           // Number of samples
+    uint32_t Min;                             // Smallest sample
+    uint32_t Max;                             // Largest sample
+    uint64_t Sum;                             // Sum of the samples, for the average
+    uint32_t Histogram[BENCH_HISTOGRAM_BINS]; // Log2 distribution of the samples
+} Bench_Result;
+
+/* Function prototypes */
+void Bench_Init(void);
+uint32_t Bench_Now(void);
+const char* Bench_Unit(void);
+void Bench_ResultInit(Bench_Result* Result, const char* Name);
+void Bench_ResultInitUnit(Bench_Result* Result, const char* Name, const char* Unit);
+void Bench_Record(Bench_Result* Result, uint32_t Sample);
+void Bench_Report(const Bench_Result* Result);
+void Bench_Finish(void);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,341 @@
+/*
+  Kernel hot path benchmark suite.
+
+  Measures the kernel paths with the cycle counter (see Bench.c for the time
+  base) and prints one JSON line per result with min/avg/max and a log2
+  histogram:
+    context_switch           activation of a higher priority task until it runs
+    svc_activate/terminate   service call round trip without a context switch
+    svc_delay                OS_DelayTask(0) round trip (yield with no other task)
+    tick_delayed_N           SysTick handler cost seen by a task with N delayed tasks
+    mutex_acquire/release    uncontended mutex
+    mutex_handoff            release by the owner until the blocked waiter runs
+    semaphore_handoff        release by the holder until the blocked waiter runs
+    semaphore_pingpong       release until the waiter gave the semaphore back
+    notify_handoff           OS_Notify until the waiting task runs
+    event_wake               OS_SetEventBits until the waiting task runs
+    pool_alloc/free          fixed-size block pool, no contention
+    critical_section         OS_EnterCritical + OS_ExitCritical round trip
+    masked_max               longest time the kernel interrupt band was masked by a
+                             critical section (tick and FromISR ones included, on
+                             the host the tick signal handler is masked as a whole
+                             and not counted), one sample, only with
+                             OS_PROFILING_ENABLED (on by default in the host build)
+
+  Target: add Bench.c to the project and set OS_PRIVILEGED_TASKS in Config.h.
+  On QEMU run with "-M stm32vldiscovery -semihosting -nographic -kernel app.elf"
+  (or any Cortex-M3 machine), on silicon attach a debugger with semihosting.
+  Host: make -C src/port/POSIX bench
+*/
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Mutex.h"
+#include "Semaphore.h"
+#include "EventGroup.h"
+#include "MemManag.h"
+#include "Bench.h"
+
+#define BENCH_ITERATIONS        1000
+#define BENCH_TICK_WINDOW       250      // Ticks sampled for each number of delayed tasks
+#define BENCH_MAX_SLEEPERS      16
+#define BENCH_SLEEP_TICKS       0x00FFFFFF
+#define BENCH_GAP_FACTOR        8        // A loop iteration this much longer than the fastest one was interrupted
+#define BENCH_POOL_BLOCK_SIZE   32
+#define BENCH_POOL_BLOCKS       4
+
+OS_TCB Runner, High, HighM, HighS, HighN, Waiter, Low, Spinner;
+OS_TCB Sleepers[BENCH_MAX_SLEEPERS];
+
+OS_Mutex m1;
+OS_Semaphore s1;
+OS_EventGroup e1;
+OS_MemPool p1;
+void* PoolMemory[OS_POOL_WORDS(BENCH_POOL_BLOCK_SIZE, BENCH_POOL_BLOCKS)];
+
+Bench_Result ContextSwitch, SvcActivate, SvcTerminate, SvcDelay;
+Bench_Result MutexAcquire, MutexRelease, MutexHandoff;
+Bench_Result SemaphoreHandoff, SemaphorePingPong, NotifyHandoff, EventWake;
+Bench_Result PoolAlloc, PoolFree;
+Bench_Result CriticalSection, MaskedMax;
+
+static const uint8_t TickSleepers[] = {0, 4, 8, 16};
+static const char* TickNames[] = {"tick_delayed_0", "tick_delayed_4", "tick_delayed_8", "tick_delayed_16"};
+#define BENCH_TICK_STEPS  (sizeof(TickSleepers) / sizeof(TickSleepers[0]))
+Bench_Result TickCost[BENCH_TICK_STEPS];
+
+/* Time stamps taken by the runner right before waking a measured task */
+volatile uint32_t SwitchStart, HandoffStart, EventStart;
+
+/* Tick cost sampling window, WindowGeneration changes whenever the runner runs */
+Bench_Result* volatile TickWindow;
+volatile uint32_t WindowGeneration;
+
+void high (){
+	while(1){
+		Bench_Record(&ContextSwitch, Bench_Now() - SwitchStart);
+		OS_TerminateTask(&High);
+	}
+}
+
+void highMutex (){
+	while(1){
+		OS_AcquireMutex(&m1, &HighM);    // Blocks until the runner hands the mutex over
+		Bench_Record(&MutexHandoff, Bench_Now() - HandoffStart);
+		OS_ReleaseMutex(&m1);
+		OS_TerminateTask(&HighM);
+	}
+}
+
+void highSemaphore (){
+	while(1){
+		OS_AcquireSemaphore(&s1, &HighS); // Blocks until the runner releases
+		Bench_Record(&SemaphoreHandoff, Bench_Now() - HandoffStart);
+		OS_ReleaseSemaphore(&s1);
+		OS_TerminateTask(&HighS);
+	}
+}
+
+void highNotify (){
+	while(1){
+		OS_NotifyWait(0xFFFFFFFF, NULL, OS_WAIT_FOREVER);
+		Bench_Record(&NotifyHandoff, Bench_Now() - HandoffStart);
+	}
+}
+
+void waiter (){
+	while(1){
+		OS_WaitForEventBits(&e1, 1, 0, 1, OS_WAIT_FOREVER);
+		Bench_Record(&EventWake, Bench_Now() - EventStart);
+		OS_TerminateTask(&Waiter);
+	}
+}
+
+void low (){
+	while(1){
+	}
+}
+
+void sleeper (){
+	while(1){
+		OS_DelayTask(OS_GetCurrentTask(), BENCH_SLEEP_TICKS);
+	}
+}
+
+/* Lowest priority task: any long gap between two time stamps is the tick preempting it */
+void spinner (){
+	uint32_t Previous = Bench_Now();
+	uint32_t PreviousGeneration = WindowGeneration;
+	uint32_t FastestLoop = 0xFFFFFFFF;
+
+	while(1){
+		uint32_t Now = Bench_Now();
+		uint32_t Generation = WindowGeneration;
+		uint32_t Gap = Now - Previous;
+		Bench_Result* Window = TickWindow;
+
+		if(Gap < FastestLoop)
+			FastestLoop = Gap;
+		// Gaps that include the runner itself are discarded
+		if((Window != NULL) && (Generation == PreviousGeneration) &&
+		   (Gap > (FastestLoop * BENCH_GAP_FACTOR)))
+			Bench_Record(Window, Gap - FastestLoop);
+
+		Previous = Now;
+		PreviousGeneration = Generation;
+	}
+}
+
+void runner (){
+	uint32_t Start;
+	uint8_t Active = 0;
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		SwitchStart = Bench_Now();
+		OS_ActivateTask(&High);
+	}
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		Start = Bench_Now();
+		OS_ActivateTask(&Low);
+		Bench_Record(&SvcActivate, Bench_Now() - Start);
+		Start = Bench_Now();
+		OS_TerminateTask(&Low);
+		Bench_Record(&SvcTerminate, Bench_Now() - Start);
+	}
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		Start = Bench_Now();
+		OS_DelayTask(&Runner, 0);
+		Bench_Record(&SvcDelay, Bench_Now() - Start);
+	}
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		Start = Bench_Now();
+		OS_AcquireMutex(&m1, &Runner);
+		Bench_Record(&MutexAcquire, Bench_Now() - Start);
+		Start = Bench_Now();
+		OS_ReleaseMutex(&m1);
+		Bench_Record(&MutexRelease, Bench_Now() - Start);
+	}
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		OS_AcquireMutex(&m1, &Runner);
+		OS_ActivateTask(&HighM);         // Runs and blocks on the mutex
+		HandoffStart = Bench_Now();
+		OS_ReleaseMutex(&m1);
+	}
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		OS_AcquireSemaphore(&s1, &Runner);
+		OS_ActivateTask(&HighS);         // Runs and blocks on the semaphore
+		HandoffStart = Bench_Now();
+		OS_ReleaseSemaphore(&s1);
+		Bench_Record(&SemaphorePingPong, Bench_Now() - HandoffStart);
+	}
+
+	OS_ActivateTask(&HighN);             // Runs and waits for a notification
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		HandoffStart = Bench_Now();
+		OS_Notify(&HighN, 1, OS_NOTIFY_SET_BITS);
+	}
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		void* Block;
+		Start = Bench_Now();
+		Block = OS_PoolAlloc(&p1);
+		Bench_Record(&PoolAlloc, Bench_Now() - Start);
+		Start = Bench_Now();
+		OS_PoolFree(&p1, Block);
+		Bench_Record(&PoolFree, Bench_Now() - Start);
+	}
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		Start = Bench_Now();
+		OS_EnterCritical();
+		OS_ExitCritical();
+		Bench_Record(&CriticalSection, Bench_Now() - Start);
+	}
+
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		OS_ActivateTask(&Waiter);        // Runs and waits for the bits
+		EventStart = Bench_Now();
+		OS_SetEventBits(&e1, 1);
+	}
+
+	// Tick cost while more and more tasks sit in the delay list
+	for(uint8_t Step = 0; Step < BENCH_TICK_STEPS; Step++){
+		while(Active < TickSleepers[Step]){
+			OS_ActivateTask(&Sleepers[Active++]);
+		}
+		TickWindow = &TickCost[Step];
+		WindowGeneration++;
+		OS_DelayTask(&Runner, BENCH_TICK_WINDOW);
+		WindowGeneration++;
+		TickWindow = NULL;
+	}
+
+	Bench_Report(&ContextSwitch);
+	Bench_Report(&SvcActivate);
+	Bench_Report(&SvcTerminate);
+	Bench_Report(&SvcDelay);
+	for(uint8_t Step = 0; Step < BENCH_TICK_STEPS; Step++){
+		Bench_Report(&TickCost[Step]);
+	}
+	Bench_Report(&MutexAcquire);
+	Bench_Report(&MutexRelease);
+	Bench_Report(&MutexHandoff);
+	Bench_Report(&SemaphoreHandoff);
+	Bench_Report(&SemaphorePingPong);
+	Bench_Report(&NotifyHandoff);
+	Bench_Report(&EventWake);
+	Bench_Report(&PoolAlloc);
+	Bench_Report(&PoolFree);
+	Bench_Report(&CriticalSection);
+#if OS_PROFILING_ENABLED
+	Bench_Record(&MaskedMax, OS_ProfileData.MaskedMaxCycles);
+	Bench_Report(&MaskedMax);
+#endif
+	Bench_Finish();
+}
+
+static void CreateTask(OS_TCB* Task, void (*func)(void), uint8_t Priority, const char* Name, uint16_t StackSize){
+	OS_ErrorStatus loc_ERROR;
+
+	Task->func = func;
+	Task->Priority = Priority;
+	strcpy(Task->TaskName, Name);
+	Task->StackSize = StackSize;
+
+	loc_ERROR = OS_CreateTask(Task);
+	if(loc_ERROR != OS_OK)
+		while(1);
+}
+
+int main(void)
+{
+  HAL_Init();
+
+  SystemClock_Config();
+
+  OS_ErrorStatus loc_ERROR = OS_OK;
+
+  loc_ERROR = OS_Init();
+  if(loc_ERROR != OS_OK)
+	  while(1);
+
+  Bench_Init();
+
+  OS_InitMutex(&m1);
+  OS_InitSemaphore(&s1, 1);
+  OS_InitEventGroup(&e1);
+  OS_PoolInit(&p1, PoolMemory, BENCH_POOL_BLOCK_SIZE, BENCH_POOL_BLOCKS);
+
+  Bench_ResultInit(&ContextSwitch, "context_switch");
+  Bench_ResultInit(&SvcActivate, "svc_activate");
+  Bench_ResultInit(&SvcTerminate, "svc_terminate");
+  Bench_ResultInit(&SvcDelay, "svc_delay");
+  Bench_ResultInit(&MutexAcquire, "mutex_acquire");
+  Bench_ResultInit(&MutexRelease, "mutex_release");
+  Bench_ResultInit(&MutexHandoff, "mutex_handoff");
+  Bench_ResultInit(&SemaphoreHandoff, "semaphore_handoff");
+  Bench_ResultInit(&SemaphorePingPong, "semaphore_pingpong");
+  Bench_ResultInit(&NotifyHandoff, "notify_handoff");
+  Bench_ResultInit(&EventWake, "event_wake");
+  Bench_ResultInit(&PoolAlloc, "pool_alloc");
+  Bench_ResultInit(&PoolFree, "pool_free");
+  Bench_ResultInit(&CriticalSection, "critical_section");
+  Bench_ResultInit(&MaskedMax, "masked_max");
+  for(uint8_t Step = 0; Step < BENCH_TICK_STEPS; Step++){
+	  Bench_ResultInit(&TickCost[Step], TickNames[Step]);
+  }
+
+  CreateTask(&Runner, runner, 2, "Runner", 1024);
+  CreateTask(&High, high, 1, "High", 512);
+  CreateTask(&HighM, highMutex, 1, "HighM", 512);
+  CreateTask(&HighS, highSemaphore, 1, "HighS", 512);
+  CreateTask(&HighN, highNotify, 1, "HighN", 512);
+  CreateTask(&Waiter, waiter, 1, "Waiter", 512);
+  CreateTask(&Low, low, 3, "Low", 256);
+  CreateTask(&Spinner, spinner, 200, "Spinner", 512);
+  for(uint8_t i = 0; i < BENCH_MAX_SLEEPERS; i++){
+	  CreateTask(&Sleepers[i], sleeper, 4, "Sleeper", 256);
+  }
+
+  loc_ERROR = OS_ActivateTask(&Runner);
+  if(loc_ERROR != OS_OK)
+	  while(1);
+  loc_ERROR = OS_ActivateTask(&Spinner);
+  if(loc_ERROR != OS_OK)
+	  while(1);
+
+  OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
@@ -0,0 +1,113 @@
+/*
+  Scheduler service call cost benchmark.
+
+  The driver task activates and terminates lower priority tasks, so each
+  service call measures the scheduler bookkeeping without a context switch,
+  with BENCH_NO_OF_TASKS tasks created. Built once per scheduler policy
+  (OS_SCHEDULER_POLICY), results printed as JSON lines like KernelBench, the
+  policy in the name of every result:
+    activate_<policy>        OS_ActivateTask service call (kernel profiling)
+    terminate_<policy>       OS_TerminateTask service call (kernel profiling)
+
+  Target: add Bench.c to the project and set OS_PROFILING_ENABLED and
+  OS_PRIVILEGED_TASKS in Config.h.
+  Host: make -C src/port/POSIX bench
+*/
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Bench.h"
+
+#if !OS_PROFILING_ENABLED
+#error "SchedulerBench requires OS_PROFILING_ENABLED in Config.h"
+#endif
+
+#if OS_SCHEDULER_POLICY == OS_SCHED_SORTED_TABLE
+#define BENCH_POLICY         "sorted_table"
+#elif OS_SCHEDULER_POLICY == OS_SCHED_PRIORITY_BITMAP
+#define BENCH_POLICY         "bitmap"
+#else
+#define BENCH_POLICY         "edf"
+#endif
+
+#define BENCH_NO_OF_TASKS    32
+#define BENCH_ITERATIONS     1000
+
+OS_TCB Driver;
+OS_TCB Workers[BENCH_NO_OF_TASKS];
+
+Bench_Result Activate, Terminate;
+
+void worker (){
+	while(1){
+	}
+}
+
+void driver (){
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){
+		OS_TCB* Worker = &Workers[i % BENCH_NO_OF_TASKS];
+
+		OS_ActivateTask(Worker);
+		Bench_Record(&Activate, OS_ProfileData.SvcLastCycles);
+
+		OS_TerminateTask(Worker);
+		Bench_Record(&Terminate, OS_ProfileData.SvcLastCycles);
+	}
+
+	Bench_Report(&Activate);
+	Bench_Report(&Terminate);
+	Bench_Finish();
+}
+
+int main(void)
+{
+  HAL_Init();
+
+  SystemClock_Config();
+
+  OS_ErrorStatus ERROR = OS_OK;
+
+  ERROR = OS_Init();
+  if(ERROR != OS_OK)
+	  while(1);
+
+  Bench_Init();
+
+  Bench_ResultInit(&Activate, "activate_" BENCH_POLICY);
+  Bench_ResultInit(&Terminate, "terminate_" BENCH_POLICY);
+
+  Driver.func = driver;
+  Driver.Priority = 1;
+  strcpy(Driver.TaskName,"Driver");
+  Driver.StackSize = 512;
+
+  ERROR = OS_CreateTask(&Driver);
+  if(ERROR != OS_OK)
+	  while(1);
+
+  // Lower priority workers, each on its own level
+  for(uint8_t i = 0; i < BENCH_NO_OF_TASKS; i++){
+	  Workers[i].func = worker;
+	  Workers[i].Priority = 10 + i;
+	  strcpy(Workers[i].TaskName,"Worker");
+	  Workers[i].StackSize = 256;
+
+	  ERROR = OS_CreateTask(&Workers[i]);
+	  if(ERROR != OS_OK)
+		  while(1);
+  }
+
+  ERROR = OS_ActivateTask(&Driver);
+  if(ERROR != OS_OK)
+	  while(1);
+
+  OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
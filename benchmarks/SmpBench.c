@@ -0,0 +1,145 @@
+/*
+  SMP throughput benchmark.
+
+  BENCH_WORKERS CPU-bound workers of equal priority, free to run on every core,
+  repeat a fixed job and count the jobs they complete. A driver task of higher
+  priority samples the counters every BENCH_WINDOW ticks. Built once per core
+  count (OS_NUM_CORES = 1 to 4 on the host), the results compare how the
+  throughput scales with the cores. One sample per window, printed as JSON
+  lines like KernelBench, the core count in the name of every result:
+    throughput_<n>cores      jobs completed by all the workers in the window
+    cores_<n>cores           cores that ran a worker during the window
+
+  The host port simulates every core with a thread, the scaling it measures is
+  bounded by the CPUs of the host.
+  Host: make -C src/port/POSIX bench
+*/
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Bench.h"
+
+#if OS_SCHEDULER_POLICY != OS_SCHED_PRIORITY_BITMAP
+#error "SmpBench requires OS_SCHED_PRIORITY_BITMAP in Config.h"
+#endif
+
+#define BENCH_WINDOWS             20
+#define BENCH_WINDOW              50       // Ticks between two samples
+#define BENCH_WORKERS             8
+#define BENCH_DRIVER_PRIORITY     2
+#define BENCH_WORKER_PRIORITY     3
+#define BENCH_JOB_ROUNDS          20000    // Iterations of one job
+
+#define BENCH_STRING(x)           #x
+#define BENCH_NAME(Name, Cores)   Name "_" BENCH_STRING(Cores) "cores"
+
+OS_TCB Driver;
+OS_TCB Workers[BENCH_WORKERS];
+
+Bench_Result Throughput, Cores;
+
+volatile uint32_t Jobs[BENCH_WORKERS];         // Jobs completed by each worker
+volatile uint8_t CoresSeen;                    // Cores that ran a worker, bit n for core n
+
+/* One job: a fixed amount of CPU work without kernel calls */
+static __attribute__((noinline)) uint32_t job (uint32_t Seed){
+	for(uint32_t i = 0; i < BENCH_JOB_ROUNDS; i++){
+		Seed = Seed * 1664525U + 1013904223U;
+	}
+	return Seed;
+}
+
+void worker (){
+	uint8_t Id = (uint8_t)(OS_GetCurrentTask() - Workers);
+	volatile uint32_t Seed = Id;
+
+	while(1){
+		Seed = job(Seed);
+		Jobs[Id]++;
+		__atomic_fetch_or(&CoresSeen, (uint8_t)(1U << OS_GetCoreId()), __ATOMIC_RELAXED);
+	}
+}
+
+/* Total of the jobs completed by the workers */
+static uint32_t jobs (void){
+	uint32_t Total = 0;
+
+	for(uint8_t i = 0; i < BENCH_WORKERS; i++){
+		Total += Jobs[i];
+	}
+	return Total;
+}
+
+void driver (){
+	uint32_t Last = jobs();
+
+	for(uint32_t Window = 0; Window < BENCH_WINDOWS; Window++){
+		CoresSeen = 0;
+		OS_DelayTask(&Driver, BENCH_WINDOW);
+
+		uint32_t Now = jobs();
+		Bench_Record(&Throughput, Now - Last);
+		Bench_Record(&Cores, (uint32_t)__builtin_popcount(CoresSeen));
+		Last = Now;
+	}
+
+	Bench_Report(&Throughput);
+	Bench_Report(&Cores);
+	Bench_Finish();
+}
+
+int main(void)
+{
+  HAL_Init();
+
+  SystemClock_Config();
+
+  OS_ErrorStatus ERROR = OS_OK;
+
+  ERROR = OS_Init();
+  if(ERROR != OS_OK)
+	  while(1);
+
+  Bench_Init();
+
+  Bench_ResultInitUnit(&Throughput, BENCH_NAME("throughput", OS_NUM_CORES), "jobs");
+  Bench_ResultInitUnit(&Cores, BENCH_NAME("cores", OS_NUM_CORES), "cores");
+
+  Driver.func = driver;
+  Driver.Priority = BENCH_DRIVER_PRIORITY;
+  strcpy(Driver.TaskName,"Driver");
+  Driver.StackSize = 512;
+
+  ERROR = OS_CreateTask(&Driver);
+  if(ERROR != OS_OK)
+	  while(1);
+
+  // Affinity left to 0: the workers may run on every core
+  for(uint8_t i = 0; i < BENCH_WORKERS; i++){
+	  Workers[i].func = worker;
+	  Workers[i].Priority = BENCH_WORKER_PRIORITY;
+	  strcpy(Workers[i].TaskName,"Worker");
+	  Workers[i].StackSize = 512;
+
+	  ERROR = OS_CreateTask(&Workers[i]);
+	  if(ERROR != OS_OK)
+		  while(1);
+	  ERROR = OS_ActivateTask(&Workers[i]);
+	  if(ERROR != OS_OK)
+		  while(1);
+  }
+
+  ERROR = OS_ActivateTask(&Driver);
+  if(ERROR != OS_OK)
+	  while(1);
+
+  OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
@@ -0,0 +1,196 @@
+/*
+  Preemption threshold benchmark.
+
+  A driver task releases a burst of BENCH_WORKERS jobs of increasing priority,
+  BENCH_RELEASE_GAP ticks apart, each job running for BENCH_JOB_TICKS ticks
+  with a BENCH_JOB_BUFFER byte buffer on its stack. The task set runs twice:
+  with fixed priorities, where every release preempts the job in progress,
+  then with the threshold of every worker raised to the highest worker
+  priority, so that a job runs to completion before the next one starts
+  (the driver, above the threshold, still preempts the workers).
+  One sample per burst, printed as JSON lines like KernelBench:
+    switches[_threshold]     context switches between workers in the burst
+    nesting[_threshold]      deepest chain of jobs in progress at the same time
+    stack[_threshold]        worst case stack of the jobs in progress at the same
+                             time (bytes): what the preempted jobs keep on their
+                             stacks, the stack a group sharing one stack needs
+
+  Target: add Bench.c to the project and set OS_PRIVILEGED_TASKS in Config.h.
+  Host: make -C src/port/POSIX bench
+*/
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Bench.h"
+
+#if OS_SCHEDULER_POLICY != OS_SCHED_PRIORITY_BITMAP
+#error "ThresholdBench requires OS_SCHED_PRIORITY_BITMAP in Config.h"
+#endif
+
+#define BENCH_BURSTS              50
+#define BENCH_WORKERS             4
+#define BENCH_DRIVER_PRIORITY     2
+#define BENCH_WORKER_PRIORITY     3        // Highest worker priority, the threshold of the second run
+#define BENCH_RELEASE_GAP         1        // Ticks between two releases of a burst
+#define BENCH_JOB_TICKS           4        // Ticks of CPU time used by each job
+#define BENCH_JOB_BUFFER          256      // Bytes of working data kept on the stack by each job
+#define BENCH_NO_WORKER           0xFF
+
+OS_TCB Driver;
+OS_TCB Workers[BENCH_WORKERS];
+
+Bench_Result Switches[2], Nesting[2], Stack[2];
+
+/* Burst accounting, updated by the jobs */
+volatile uint8_t Running;                      // Worker that ran last
+volatile uint32_t BurstSwitches;
+volatile uint32_t InProgress, MaxInProgress;   // Jobs started and not completed
+volatile uint32_t StackInUse, MaxStackInUse;   // Stack bytes held by the jobs in progress
+volatile uint32_t JobsDone;
+uintptr_t WorkerBase[BENCH_WORKERS];           // Stack address at the top of each worker loop
+
+/* One job: keeps its buffer live on the stack for BENCH_JOB_TICKS ticks of CPU time */
+static __attribute__((noinline)) void job (uint8_t Id){
+	volatile uint8_t Buffer[BENCH_JOB_BUFFER];
+	uint32_t Depth = (uint32_t)(WorkerBase[Id] - (uintptr_t)Buffer);
+	uint32_t Used = 0, Last = OS_GetTickCount();
+
+	OS_EnterCritical();
+	InProgress++;
+	StackInUse += Depth;
+	if(InProgress > MaxInProgress)
+		MaxInProgress = InProgress;
+	if(StackInUse > MaxStackInUse)
+		MaxStackInUse = StackInUse;
+	OS_ExitCritical();
+
+	// Only the ticks this job is running count as its CPU time
+	while(Used < BENCH_JOB_TICKS){
+		uint32_t Now = OS_GetTickCount();
+
+		if(Running != Id){
+			Running = Id;
+			BurstSwitches++;
+			Last = Now;
+		}
+		if(Now != Last){
+			Used++;
+			Last = Now;
+		}
+		Buffer[Now % BENCH_JOB_BUFFER]++;
+	}
+
+	OS_EnterCritical();
+	InProgress--;
+	StackInUse -= Depth;
+	JobsDone++;
+	OS_ExitCritical();
+}
+
+void worker (){
+	uint8_t Id = (uint8_t)(OS_GetCurrentTask() - Workers);
+	volatile uint8_t Base;
+
+	WorkerBase[Id] = (uintptr_t)&Base;
+	while(1){
+		OS_NotifyWait(0xFFFFFFFF, NULL, OS_WAIT_FOREVER);
+		job(Id);
+	}
+}
+
+void driver (){
+	for(uint8_t Run = 0; Run < 2; Run++){
+		for(uint8_t i = 0; i < BENCH_WORKERS; i++){
+			Workers[i].PreemptionThreshold = Run ? BENCH_WORKER_PRIORITY : 0;
+		}
+
+		for(uint32_t Burst = 0; Burst < BENCH_BURSTS; Burst++){
+			Running = BENCH_NO_WORKER;
+			BurstSwitches = 0;
+			MaxInProgress = 0;
+			MaxStackInUse = 0;
+			JobsDone = 0;
+
+			// Lowest priority first, each release finds the previous jobs still running
+			for(uint8_t i = BENCH_WORKERS; i-- > 0;){
+				OS_Notify(&Workers[i], 1, OS_NOTIFY_SET_BITS);
+				OS_DelayTask(&Driver, BENCH_RELEASE_GAP);
+			}
+			while(JobsDone < BENCH_WORKERS){
+				OS_DelayTask(&Driver, 1);
+			}
+
+			// The first job of the burst is not a switch between workers
+			Bench_Record(&Switches[Run], BurstSwitches - 1);
+			Bench_Record(&Nesting[Run], MaxInProgress);
+			Bench_Record(&Stack[Run], MaxStackInUse);
+		}
+	}
+
+	for(uint8_t Run = 0; Run < 2; Run++){
+		Bench_Report(&Switches[Run]);
+		Bench_Report(&Nesting[Run]);
+		Bench_Report(&Stack[Run]);
+	}
+	Bench_Finish();
+}
+
+int main(void)
+{
+  HAL_Init();
+
+  SystemClock_Config();
+
+  OS_ErrorStatus ERROR = OS_OK;
+
+  ERROR = OS_Init();
+  if(ERROR != OS_OK)
+	  while(1);
+
+  Bench_Init();
+
+  Bench_ResultInitUnit(&Switches[0], "switches", "switches");
+  Bench_ResultInitUnit(&Switches[1], "switches_threshold", "switches");
+  Bench_ResultInitUnit(&Nesting[0], "nesting", "jobs");
+  Bench_ResultInitUnit(&Nesting[1], "nesting_threshold", "jobs");
+  Bench_ResultInitUnit(&Stack[0], "stack", "bytes");
+  Bench_ResultInitUnit(&Stack[1], "stack_threshold", "bytes");
+
+  Driver.func = driver;
+  Driver.Priority = BENCH_DRIVER_PRIORITY;
+  strcpy(Driver.TaskName,"Driver");
+  Driver.StackSize = 512;
+
+  ERROR = OS_CreateTask(&Driver);
+  if(ERROR != OS_OK)
+	  while(1);
+
+  // One priority level per worker, the last one is the lowest
+  for(uint8_t i = 0; i < BENCH_WORKERS; i++){
+	  Workers[i].func = worker;
+	  Workers[i].Priority = BENCH_WORKER_PRIORITY + i;
+	  strcpy(Workers[i].TaskName,"Worker");
+	  Workers[i].StackSize = 1024;
+
+	  ERROR = OS_CreateTask(&Workers[i]);
+	  if(ERROR != OS_OK)
+		  while(1);
+	  ERROR = OS_ActivateTask(&Workers[i]);
+	  if(ERROR != OS_OK)
+		  while(1);
+  }
+
+  ERROR = OS_ActivateTask(&Driver);
+  if(ERROR != OS_OK)
+	  while(1);
+
+  OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
@@ -0,0 +1,128 @@
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+
+/*
+  Two periodic control loops whose utilisation (2/5 + 4/7 = 97 %) is above the
+  rate monotonic bound for two tasks (83 %), with deadlines equal to periods.
+  Misses[] counts the jobs that completed after their deadline.
+  With OS_SCHEDULER_POLICY set to OS_SCHED_EDF both loops meet every deadline,
+  with fixed priorities (rate monotonic: shorter period, higher priority) the
+  slow loop keeps missing. OS_GetDeadlineMisses gives the kernel count under EDF.
+*/
+#define NO_OF_LOOPS       2
+
+typedef struct {
+	uint32_t Period;                  // Ticks between releases, also the deadline
+	uint32_t WorkTicks;               // CPU ticks consumed by each job
+} LoopParameters;
+
+static const LoopParameters Loops[NO_OF_LOOPS] = {
+	{5, 2},
+	{7, 4}
+};
+
+OS_TCB t1,t2;
+uint8_t Task1Led,Task2Led;
+volatile uint32_t Ticks;
+volatile uint32_t UsedTicks[NO_OF_LOOPS];   // Ticks each loop actually ran
+uint32_t Jobs[NO_OF_LOOPS], Misses[NO_OF_LOOPS];
+
+/* Charges the tick to the loop it interrupted */
+void tick (){
+	Ticks++;
+	if(OS_GetCurrentTask() == &t1)
+		UsedTicks[0]++;
+	else if(OS_GetCurrentTask() == &t2)
+		UsedTicks[1]++;
+}
+
+/* Consumes NoOfTicks of CPU time, whatever the preemptions */
+void work (uint8_t Loop, uint32_t NoOfTicks){
+	uint32_t Start = UsedTicks[Loop];
+	while((UsedTicks[Loop] - Start) < NoOfTicks){
+	}
+}
+
+/* One job per period, the next release is kept on the period grid */
+void loop (uint8_t Loop, OS_TCB* Task, uint8_t* Led){
+	uint32_t Release;
+
+	OS_DelayTask(Task, 1);                // Both loops are released on the next tick
+	Release = Ticks;
+	while(1){
+		*Led ^= 1;
+		work(Loop, Loops[Loop].WorkTicks);
+		Jobs[Loop]++;
+		if((Ticks - Release) > Loops[Loop].Period)
+			Misses[Loop]++;
+		Release += Loops[Loop].Period;
+		if((int32_t)(Release - Ticks) > 0)
+			OS_DelayTask(Task, Release - Ticks);
+		else
+			Release = Ticks;              // Overran the whole period: restart from now
+	}
+}
+
+void task1 (){
+	loop(0, &t1, &Task1Led);
+}
+
+void task2 (){
+	loop(1, &t2, &Task2Led);
+}
+
+int main(void)
+{
+
+  HAL_Init();
+
+  SystemClock_Config();
+
+  MX_GPIO_Init();
+
+  OS_ErrorStatus loc_ERROR = OS_OK;
+
+  loc_ERROR = OS_Init();
+  if(loc_ERROR != OS_OK)
+  	while(1);
+
+  OS_RegisterSysTickHook(tick);
+
+  t1.func = task1;
+  t1.Priority = 1 ;
+  t1.RelativeDeadline = Loops[0].Period;
+  strcpy(t1.TaskName,"FastLoop");
+  t1.StackSize = 1024;
+
+  loc_ERROR = OS_CreateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	t2.func = task2;
+  	t2.Priority = 2 ;
+  	t2.RelativeDeadline = Loops[1].Period;
+  	strcpy(t2.TaskName,"SlowLoop");
+  	t2.StackSize = 1024;
+
+  	loc_ERROR = OS_CreateTask(&t2);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	loc_ERROR= OS_ActivateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  			while(1);
+  	loc_ERROR= OS_ActivateTask(&t2);
+  	if(loc_ERROR != OS_OK)
+  			while(1);
+
+  	OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
@@ -0,0 +1,131 @@
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Queue.h"
+#include "MemManag.h"
+
+/*
+  Interrupt to task hand-off: the SysTick hook stands in for a peripheral
+  interrupt (it runs in handler mode, so the services requested through SVC
+  cannot be used there). Every SAMPLE_PERIOD ticks it takes a buffer from a
+  pool, fills it and posts it with OS_QueueSendFromISR; every BATCH samples
+  it also notifies the logger with OS_NotifyFromISR. The kernel state is
+  updated directly and a single PendSV switches to the woken task once the
+  interrupt returns.
+*/
+#define SAMPLE_PERIOD     2
+#define BATCH             10
+#define NO_OF_BUFFERS     4
+
+typedef struct {
+	uint32_t Tick;
+	uint16_t Value;
+} Sample;
+
+OS_MemPool Buffers;
+void* BufferMemory[OS_POOL_WORDS(sizeof(Sample), NO_OF_BUFFERS)];
+void* SampleBuffer[NO_OF_BUFFERS];
+OS_Queue Samples;
+OS_TCB t1,t2;
+uint8_t Task1Led,Task2Led;
+volatile uint32_t Ticks, LostSamples, ProcessedSamples, Batches;
+
+/* "Interrupt": produces a sample */
+void tick (){
+	Sample* sample;
+	Ticks++;
+	if(Ticks % SAMPLE_PERIOD)
+		return;
+	sample = (Sample*)OS_PoolAlloc(&Buffers);
+	if(sample == NULL){
+		LostSamples++;                // Consumer is late, every buffer is in use
+		return;
+	}
+	sample->Tick = Ticks;
+	sample->Value = (uint16_t)(Ticks * 7);
+	if(OS_QueueSendFromISR(&Samples, sample) != OS_QUEUE_OK){
+		OS_PoolFree(&Buffers, sample);
+		LostSamples++;
+	}
+	if((Ticks / SAMPLE_PERIOD) % BATCH == 0){
+		OS_NotifyFromISR(&t2, 1, OS_NOTIFY_INCREMENT);
+	}
+}
+
+/* Consumer: processes the samples and recycles the buffers */
+void task1 (){
+	void* Message;
+	while(1){
+		if(OS_QueueReceive(&Samples, &Message, OS_WAIT_FOREVER) == OS_QUEUE_OK){
+			Task1Led ^= 1;
+			ProcessedSamples++;
+			OS_PoolFree(&Buffers, Message);
+		}
+	}
+}
+
+/* Logger: wakes up once per batch */
+void task2 (){
+	uint32_t Count;
+	while(1){
+		if(OS_NotifyWait(0xFFFFFFFF, &Count, OS_WAIT_FOREVER) == OS_NOTIFY_OK){
+			Task2Led ^= 1;
+			Batches += Count;
+		}
+	}
+}
+
+int main(void)
+{
+
+  HAL_Init();
+
+  SystemClock_Config();
+
+  MX_GPIO_Init();
+
+  OS_ErrorStatus loc_ERROR = OS_OK;
+
+  loc_ERROR = OS_Init();
+  if(loc_ERROR != OS_OK)
+  	while(1);
+
+  OS_PoolInit(&Buffers, BufferMemory, sizeof(Sample), NO_OF_BUFFERS);
+  OS_InitQueue(&Samples, SampleBuffer, NO_OF_BUFFERS, OS_WAIT_FIFO);
+  OS_RegisterSysTickHook(tick);
+
+  t1.func = task1;
+  t1.Priority = 1 ;
+  strcpy(t1.TaskName,"Consumer");
+  t1.StackSize = 1024;
+
+  loc_ERROR = OS_CreateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	t2.func = task2;
+  	t2.Priority = 2 ;
+  	strcpy(t2.TaskName,"Logger");
+  	t2.StackSize = 1024;
+
+  	loc_ERROR = OS_CreateTask(&t2);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	loc_ERROR= OS_ActivateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  			while(1);
+  	loc_ERROR= OS_ActivateTask(&t2);
+  	if(loc_ERROR != OS_OK)
+  			while(1);
+
+  	OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
@@ -0,0 +1,123 @@
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Queue.h"
+
+/*
+  Zero-copy frame pipeline: the frames circulate between two queues of
+  pointers. The sensor task takes an empty frame, fills it and sends it to the
+  processing task, which hands it back once done. Only pointers move, the
+  frame payload is never copied.
+*/
+#define NO_OF_FRAMES      4
+#define FRAME_SIZE        512
+
+typedef struct {
+	uint32_t Sequence;
+	uint16_t Samples[FRAME_SIZE];
+} Frame;
+
+Frame Frames[NO_OF_FRAMES];
+void* FreeBuffer[NO_OF_FRAMES];
+void* FullBuffer[NO_OF_FRAMES];
+OS_Queue FreeFrames, FullFrames;
+OS_TCB t1,t2;
+uint8_t Task1Led,Task2Led;
+uint32_t ProcessedFrames, DroppedFrames;
+
+/* Sensor: fills a free frame every tick */
+void task1 (){
+	void* Message;
+	uint32_t Sequence = 0;
+	while(1){
+		Task1Led ^= 1;
+		if(OS_QueueReceive(&FreeFrames, &Message, 0) != OS_QUEUE_OK){
+			DroppedFrames++;              // Processing is late, no frame available
+		}else{
+			Frame* frame = (Frame*)Message;
+			frame->Sequence = Sequence;
+			for(uint16_t i = 0; i < FRAME_SIZE; i++){
+				frame->Samples[i] = (uint16_t)(Sequence + i);
+			}
+			OS_QueueSend(&FullFrames, frame, OS_WAIT_FOREVER);
+		}
+		Sequence++;
+		OS_DelayTask(&t1, 1);
+	}
+}
+
+/* Processing: consumes the frames and recycles them */
+void task2 (){
+	void* Message;
+	uint32_t Sum;
+	while(1){
+		if(OS_QueueReceive(&FullFrames, &Message, 100) == OS_QUEUE_OK){
+			Frame* frame = (Frame*)Message;
+			Task2Led ^= 1;
+			Sum = 0;
+			for(uint16_t i = 0; i < FRAME_SIZE; i++){
+				Sum += frame->Samples[i];
+			}
+			(void)Sum;
+			ProcessedFrames++;
+			OS_QueueSend(&FreeFrames, frame, OS_WAIT_FOREVER);
+		}
+	}
+}
+
+int main(void)
+{
+
+  HAL_Init();
+
+  SystemClock_Config();
+
+  MX_GPIO_Init();
+
+  OS_ErrorStatus loc_ERROR = OS_OK;
+
+  loc_ERROR = OS_Init();
+  if(loc_ERROR != OS_OK)
+  	while(1);
+
+  OS_InitQueue(&FreeFrames, FreeBuffer, NO_OF_FRAMES, OS_WAIT_FIFO);
+  OS_InitQueue(&FullFrames, FullBuffer, NO_OF_FRAMES, OS_WAIT_PRIORITY);
+  for(uint8_t i = 0; i < NO_OF_FRAMES; i++){
+	  OS_QueueSend(&FreeFrames, &Frames[i], 0);
+  }
+
+  t1.func = task1;
+  t1.Priority = 1 ;
+  strcpy(t1.TaskName,"Sensor");
+  t1.StackSize = 1024;
+
+  loc_ERROR = OS_CreateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	t2.func = task2;
+  	t2.Priority = 2 ;
+  	strcpy(t2.TaskName,"Processing");
+  	t2.StackSize = 1024;
+
+  	loc_ERROR = OS_CreateTask(&t2);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	loc_ERROR= OS_ActivateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  			while(1);
+  	loc_ERROR= OS_ActivateTask(&t2);
+  	if(loc_ERROR != OS_OK)
+  			while(1);
+
+  	OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
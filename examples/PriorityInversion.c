@@ -0,0 +1,129 @@
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Mutex.h"
+
+/*
+  Priority inversion scenario: the low priority task owns m1 when the high
+  priority task needs it, while a medium priority task is ready to burn CPU.
+  HighBlockedTicks holds the time the high priority task waited for m1.
+  With OS_MUTEX_PRIORITY_INHERITANCE it stays around LOW_WORK_TICKS (the low
+  task inherits the high priority and finishes its critical section first),
+  without it the medium task runs first and it grows to
+  LOW_WORK_TICKS + MEDIUM_WORK_TICKS.
+*/
+#define LOW_WORK_TICKS        5
+#define MEDIUM_WORK_TICKS     50
+
+OS_Mutex m1;
+OS_TCB t1,t2,t3;
+uint8_t Task1Led,Task2Led,Task3Led;
+volatile uint32_t Ticks;
+volatile uint32_t HighBlockedTicks, HighBlockedMaxTicks;
+
+void tick (){
+	Ticks++;
+}
+
+void busy (uint32_t NoOfTicks){
+	uint32_t Start = Ticks;
+	while((Ticks - Start) < NoOfTicks){
+	}
+}
+
+/* High priority: needs m1 right after waking up the medium task */
+void task1 (){
+	uint32_t Start;
+	while(1){
+		Task1Led ^= 1;
+		Start = Ticks;
+		OS_ActivateTask(&t2);
+		OS_AcquireMutex(&m1, &t1);
+		HighBlockedTicks = Ticks - Start;
+		if(HighBlockedTicks > HighBlockedMaxTicks)
+			HighBlockedMaxTicks = HighBlockedTicks;
+		OS_ReleaseMutex(&m1);
+		OS_TerminateTask(&t1);
+	}
+}
+
+/* Medium priority: unrelated CPU bound work */
+void task2 (){
+	while(1){
+		Task2Led ^= 1;
+		busy(MEDIUM_WORK_TICKS);
+		OS_TerminateTask(&t2);
+	}
+}
+
+/* Low priority: owns m1 for LOW_WORK_TICKS */
+void task3 (){
+	while(1){
+		Task3Led ^= 1;
+		OS_AcquireMutex(&m1, &t3);
+		OS_ActivateTask(&t1);
+		busy(LOW_WORK_TICKS);
+		OS_ReleaseMutex(&m1);
+		OS_DelayTask(&t3, 10);
+	}
+}
+
+int main(void)
+{
+
+  HAL_Init();
+
+  SystemClock_Config();
+
+  MX_GPIO_Init();
+
+  OS_ErrorStatus loc_ERROR = OS_OK;
+
+  loc_ERROR = OS_Init();
+  if(loc_ERROR != OS_OK)
+  	while(1);
+
+  OS_InitMutex(&m1);
+  OS_RegisterSysTickHook(tick);
+
+  t1.func = task1;
+  t1.Priority = 1 ;
+  strcpy(t1.TaskName,"High");
+  t1.StackSize = 1024;
+
+  loc_ERROR = OS_CreateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	t2.func = task2;
+  	t2.Priority = 2 ;
+  	strcpy(t2.TaskName,"Medium");
+  	t2.StackSize = 1024;
+
+  	loc_ERROR = OS_CreateTask(&t2);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	t3.func = task3;
+  	t3.Priority = 3;
+  	strcpy(t3.TaskName,"Low");
+  	t3.StackSize = 1024;
+
+  	loc_ERROR = OS_CreateTask(&t3);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	loc_ERROR= OS_ActivateTask(&t3);
+  	if(loc_ERROR != OS_OK)
+  			while(1);
+
+  	OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
@@ -0,0 +1,70 @@
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Timer.h"
+
+/*
+  Three LEDs blinking at different rates and a one-shot timeout, without a
+  single application task: the callbacks run in the timer daemon task
+  (OS_TIMERS_ENABLED), on its OS_TIMER_TASK_STACK_SIZE stack.
+  Every 2 s the slow timer restarts the one-shot timer, which turns the alarm
+  LED off 300 ms later, and halves the fast blink rate once.
+*/
+OS_Timer FastTimer, MediumTimer, SlowTimer, AlarmTimer;
+uint8_t FastLed, MediumLed, SlowLed, AlarmLed;
+
+/* Auto-reload timers toggle the LED passed as argument */
+void blink (OS_Timer* timer){
+	*(uint8_t*)timer->argument ^= 1;
+}
+
+void slow (OS_Timer* timer){
+	SlowLed ^= 1;
+	AlarmLed = 1;
+	OS_TimerReset(&AlarmTimer);               // Callbacks may use the timer API
+	if(FastTimer.period == 100)
+		OS_TimerChangePeriod(&FastTimer, 200);
+}
+
+void alarm (OS_Timer* timer){
+	AlarmLed = 0;
+}
+
+int main(void)
+{
+
+  HAL_Init();
+
+  SystemClock_Config();
+
+  MX_GPIO_Init();
+
+  OS_ErrorStatus loc_ERROR = OS_OK;
+
+  loc_ERROR = OS_Init();
+  if(loc_ERROR != OS_OK)
+  	while(1);
+
+  if(OS_TimerCreate(&FastTimer, blink, &FastLed, 100, OS_TIMER_AUTO_RELOAD) != OS_TIMER_OK)
+  	while(1);
+  if(OS_TimerCreate(&MediumTimer, blink, &MediumLed, 500, OS_TIMER_AUTO_RELOAD) != OS_TIMER_OK)
+  	while(1);
+  if(OS_TimerCreate(&SlowTimer, slow, NULL, 2000, OS_TIMER_AUTO_RELOAD) != OS_TIMER_OK)
+  	while(1);
+  if(OS_TimerCreate(&AlarmTimer, alarm, NULL, 300, OS_TIMER_ONE_SHOT) != OS_TIMER_OK)
+  	while(1);
+
+  OS_TimerStart(&FastTimer);
+  OS_TimerStart(&MediumTimer);
+  OS_TimerStart(&SlowTimer);
+
+  OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
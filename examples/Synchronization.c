@@ -78,8 +78,9 @@ int main(void)
 
   MX_GPIO_Init();
 
+  OS_ErrorStatus loc_ERROR = OS_OK;
 
-  OS_Init();
+  loc_ERROR = OS_Init();
   if(loc_ERROR != OS_OK)
   	while(1);
 
@@ -0,0 +1,121 @@
+#include "main.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "StreamBuffer.h"
+
+/*
+  Interrupt to task byte stream: the SysTick hook stands in for a UART receive
+  interrupt that pushes RX_BYTES bytes every tick with OS_StreamSendFromISR,
+  and every DMA_PERIOD ticks for a DMA transfer complete interrupt: the DMA
+  "writes" straight into the region reserved with OS_StreamReserve, and
+  OS_StreamCommitFromISR publishes it without a copy. Both come from the same
+  interrupt, the single writer of the stream. The reader task is only woken
+  once TRIGGER_LEVEL bytes are stored, and checks the byte sequence.
+*/
+#define STREAM_SIZE       256
+#define TRIGGER_LEVEL     32
+#define RX_BYTES          3
+#define DMA_PERIOD        8
+#define DMA_BYTES         24
+
+OS_StreamBuffer Stream;
+uint8_t StreamStorage[STREAM_SIZE];
+OS_TCB t1;
+uint8_t Task1Led;
+uint8_t NextByte;
+volatile uint32_t Ticks, DroppedBytes, ReceivedBytes, Wakeups, SequenceErrors;
+
+/* "Interrupt": UART bytes every tick, a DMA block now and then */
+void tick (){
+	uint8_t Rx[RX_BYTES];
+	uint8_t* Region;
+	uint32_t Length;
+
+	Ticks++;
+	for(uint8_t i = 0; i < RX_BYTES; i++){
+		Rx[i] = NextByte++;
+	}
+	Length = OS_StreamSendFromISR(&Stream, Rx, RX_BYTES);
+	DroppedBytes += RX_BYTES - Length;
+	NextByte -= RX_BYTES - Length;            // Resend the dropped bytes next time
+
+	if(Ticks % DMA_PERIOD)
+		return;
+
+	// The block may be split by the end of the storage: two transfers
+	for(uint32_t Left = DMA_BYTES; Left > 0; Left -= Length){
+		Length = OS_StreamReserve(&Stream, &Region);
+		if(Length == 0){
+			DroppedBytes += Left;
+			return;
+		}
+		if(Length > Left)
+			Length = Left;
+		for(uint32_t i = 0; i < Length; i++){
+			Region[i] = NextByte++;
+		}
+		OS_StreamCommitFromISR(&Stream, Length);
+	}
+}
+
+/* Reader: takes the bytes in bursts of at least TRIGGER_LEVEL */
+void task1 (){
+	uint8_t Data[64];
+	uint8_t Expected = 0;
+	uint32_t Length;
+
+	while(1){
+		Length = OS_StreamReceive(&Stream, Data, sizeof(Data), OS_WAIT_FOREVER);
+		Task1Led ^= 1;
+		Wakeups++;
+		for(uint32_t i = 0; i < Length; i++){
+			if(Data[i] != Expected)
+				SequenceErrors++;
+			Expected = Data[i] + 1;
+		}
+		ReceivedBytes += Length;
+	}
+}
+
+int main(void)
+{
+
+  HAL_Init();
+
+  SystemClock_Config();
+
+  MX_GPIO_Init();
+
+  OS_ErrorStatus loc_ERROR = OS_OK;
+
+  loc_ERROR = OS_Init();
+  if(loc_ERROR != OS_OK)
+  	while(1);
+
+  if(OS_InitStreamBuffer(&Stream, StreamStorage, STREAM_SIZE, TRIGGER_LEVEL) != OS_STREAM_INIT_OK)
+  	while(1);
+  OS_RegisterSysTickHook(tick);
+
+  t1.func = task1;
+  t1.Priority = 1 ;
+  strcpy(t1.TaskName,"Reader");
+  t1.StackSize = 1024;
+
+  loc_ERROR = OS_CreateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  		while(1);
+
+  	loc_ERROR= OS_ActivateTask(&t1);
+  	if(loc_ERROR != OS_OK)
+  			while(1);
+
+  	OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
@@ -7,21 +7,37 @@
 
   Description:
   Source file for Event Group management in an embedded RTOS.
+  Waiting tasks are queued with the request holding their mask, so setting
+  bits wakes exactly the satisfied waiters in one pass over the wait queue.
 */
 
 #include "EventGroup.h"
 #include "Tasks.h"
+#include "Port.h"
+
+/**
+ * @brief Checks whether the current bits satisfy a wait request.
+ *
+ * @param bits Current event bits.
+ * @param request Wait arguments (mask and wait-all flag).
+ * @return uint8_t 1 if the wait is satisfied.
+ */
+static uint8_t OS_EventBitsMatch(OS_EventGroupBits bits, OS_EventGroupRequest* request) {
+    if (request->waitForAllBits)
+        return ((bits & request->bits) == request->bits);
+    return ((bits & request->bits) != 0);
+}
 
 /**
  * @brief Initializes an event group.
  *
- * This function sets the event bits to 0 and initializes the waiting tasks count to 0.
+ * This function sets the event bits to 0 and initializes an empty wait queue.
  *
  * @param eventGroup Pointer to the OS_EventGroup structure to be initialized.
  */
 void OS_InitEventGroup(OS_EventGroup* eventGroup) {
     eventGroup->bits = 0;                 // Clear all event bits
-    eventGroup->numWaitingTasks = 0;      // No tasks are waiting initially
+    OS_WaitQueueInit(&eventGroup->waiters, OS_WAIT_FIFO);  // No tasks are waiting initially
 }
 
 /**
@@ -34,64 +50,173 @@ void OS_InitEventGroup(OS_EventGroup* eventGroup) {
  * @param eventBits The event bits to wait for.
  * @param waitForAllBits If set to 1, the function waits for all specified bits to be set;
  *                       if set to 0, it waits for any of the specified bits to be set.
- * @param timeout Time in milliseconds to wait before timing out.
- * @return uint8_t OS_EVENT_GROUP_OK if the event bits are set, or OS_EVENT_GROUP_TIMEOUT if the timeout occurs.
+ * @param clearOnExit If set to 1, the specified bits are cleared when the wait succeeds.
+ * @param timeout Ticks to wait before timing out, 0 to return at once or OS_WAIT_FOREVER.
+ * @return uint8_t OS_EVENT_GROUP_OK if the event bits are set, OS_EVENT_GROUP_TIMEOUT if the timeout occurs,
+ *         or OS_EVENT_GROUP_ERROR if no bit is specified.
  */
-uint8_t OS_WaitForEventBits(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits, uint8_t waitForAllBits, uint32_t timeout) {
-    OS_EventGroupBits currentBits = eventGroup->bits;
+uint8_t OS_WaitForEventBits(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits, uint8_t waitForAllBits, uint8_t clearOnExit, uint32_t timeout) {
+    OS_EventGroupRequest request;
 
-    // Check if the required bits are already set
-    if ((waitForAllBits && ((currentBits & eventBits) == eventBits)) ||
-        (!waitForAllBits && (currentBits & eventBits))) {
-        return OS_EVENT_GROUP_OK;  // Event bits already set
-    }
+    if (eventBits == 0)
+        return OS_EVENT_GROUP_ERROR;
 
-    // If not set, add the current task to the waiting list
-    OS_TCB* currentTask = OS_ControlBlock.CurrentTask;  // Access current task directly
+    request.eventGroup = eventGroup;
+    request.task = OS_GetCurrentTask();
+    request.bits = eventBits;
+    request.waitForAllBits = waitForAllBits;
+    request.clearOnExit = clearOnExit;
+    request.timeout = timeout;
+    request.state = OS_EVENT_GROUP_TIMEOUT;
 
-    // Block the task with timeout using the existing function
-    OS_DelayTask(currentTask, timeout); // Block the task and wait for event bits
+    OS_REQUEST_SERVICE_ARG(SVC_EVENT_WAIT, &request);
 
-    // After waking up (when either the bits are set or timeout occurs), check the event bits again
-    currentBits = eventGroup->bits;
-    if ((waitForAllBits && ((currentBits & eventBits) == eventBits)) ||
-        (!waitForAllBits && (currentBits & eventBits))) {
-        return OS_EVENT_GROUP_OK;  // Event bits are now set
+    if (request.state == OS_EVENT_GROUP_BLOCKED) {
+        // Woken up without the bits (timeout): stop waiting
+        OS_REQUEST_SERVICE_ARG(SVC_EVENT_WAIT, &request);
     }
 
-    return OS_EVENT_GROUP_TIMEOUT;  // Timeout occurred, event bits not set
+    return request.state;
 }
 
 /**
  * @brief Sets specified event bits in the event group.
  *
- * This function updates the event bits and activates any tasks that are waiting for the bits to be set.
+ * This function updates the event bits and wakes every waiting task whose wait is satisfied.
  *
  * @param eventGroup Pointer to the OS_EventGroup structure where the bits will be set.
  * @param eventBits The event bits to be set.
  */
 void OS_SetEventBits(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits) {
-    eventGroup->bits |= eventBits;  // Set the specified event bits
-
-    // Unblock any tasks waiting for the event bits
-    for (uint8_t i = 0; i < eventGroup->numWaitingTasks; i++) {
-        OS_TCB* task = eventGroup->waitingTasks[i];
-        // Check if the task should be activated based on the current event bits
-        if (task && ((eventGroup->bits & eventBits) == eventBits)) {
-            OS_ActivateTask(task);  // Activate the task
-            eventGroup->waitingTasks[i] = NULL;  // Remove task from the waiting list
-        }
+    OS_EventGroupRequest request;
+
+    request.eventGroup = eventGroup;
+    request.task = NULL;
+    request.bits = eventBits;
+
+    OS_REQUEST_SERVICE_ARG(SVC_EVENT_SET, &request);
+}
+
+/**
+ * @brief Sets specified event bits in the event group from an interrupt handler.
+ *
+ * The kernel state is updated directly in a critical section; a woken task of
+ * higher priority runs as soon as the interrupt returns.
+ *
+ * @param eventGroup Pointer to the OS_EventGroup structure where the bits will be set.
+ * @param eventBits The event bits to be set.
+ */
+void OS_SetEventBitsFromISR(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits) {
+    OS_EventGroupRequest request;
+    uint32_t interrupts;
+
+    request.eventGroup = eventGroup;
+    request.task = NULL;
+    request.bits = eventBits;
+
+    interrupts = OS_EnterCriticalFromISR();
+    if (OS_EventGroupSetService(&request)) {
+        OS_RescheduleFromISR();
     }
+    OS_ExitCriticalFromISR(interrupts);
 }
 
 /**
  * @brief Clears specified event bits in the event group.
  *
- * This function resets the specified bits in the event group.
+ * This function resets the specified bits in the event group. The update is
+ * retried if a service call sets bits meanwhile, so no set is lost.
  *
  * @param eventGroup Pointer to the OS_EventGroup structure where the bits will be cleared.
  * @param eventBits The event bits to be cleared.
  */
 void OS_ClearEventBits(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits) {
-    eventGroup->bits &= ~eventBits;  // Clear the specified bits
+    OS_EventGroupBits bits;
+
+    do {
+        bits = (OS_EventGroupBits)OS_LOAD_EXCLUSIVE(&eventGroup->bits) & ~eventBits;  // Clear the specified bits
+    } while (OS_STORE_EXCLUSIVE(bits, &eventGroup->bits));
+}
+
+/**
+ * @brief Kernel side of OS_WaitForEventBits.
+ *
+ * @param request Wait arguments, the state is written back.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_EventGroupWaitService(OS_EventGroupRequest* request) {
+    OS_EventGroup* eventGroup = request->eventGroup;
+
+    // Already completed by OS_SetEventBits while the caller was waking up
+    if (request->state == OS_EVENT_GROUP_OK)
+        return 0;
+
+    // Second call of a blocked waiter: the timeout expired
+    if (request->state == OS_EVENT_GROUP_BLOCKED) {
+        OS_WaitQueueRemove(request->task);
+        request->state = OS_EVENT_GROUP_TIMEOUT;
+        return 0;
+    }
+
+    if (OS_EventBitsMatch(eventGroup->bits, request)) {
+        if (request->clearOnExit)
+            eventGroup->bits &= ~request->bits;
+        request->state = OS_EVENT_GROUP_OK;
+        return 0;
+    }
+
+    if (request->timeout == 0) {
+        request->state = OS_EVENT_GROUP_TIMEOUT;
+        return 0;
+    }
+
+    request->state = OS_EVENT_GROUP_BLOCKED;
+    OS_WaitQueueBlock(&eventGroup->waiters, request->task, request, request->timeout);
+    return 1;
+}
+
+/**
+ * @brief Kernel side of OS_SetEventBits.
+ *
+ * Every waiter is checked against the new bits in a single pass; the bits of
+ * the satisfied clear-on-exit waiters are cleared only after the pass, so all
+ * the tasks waiting for the same event are released by one set.
+ *
+ * @param request Set arguments.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_EventGroupSetService(OS_EventGroupRequest* request) {
+    OS_EventGroup* eventGroup = request->eventGroup;
+    OS_ListNode* node = eventGroup->waiters.Tasks.Head;
+    OS_ListNode* last;
+    OS_ListNode* next;
+    OS_EventGroupBits clearBits = 0;
+    uint8_t woken = 0;
+
+    eventGroup->bits |= request->bits;  // Set the specified event bits
+
+    if (node == NULL)
+        return 0;
+
+    // Waking a task unlinks its node, so the successor and the last node are kept aside
+    last = node->Prev;
+    while (1) {
+        OS_TCB* task = (OS_TCB*)node->Owner;
+        OS_EventGroupRequest* pending = (OS_EventGroupRequest*)task->WaitRequest;
+
+        next = node->Next;
+        if (OS_EventBitsMatch(eventGroup->bits, pending)) {
+            if (pending->clearOnExit)
+                clearBits |= pending->bits;
+            pending->state = OS_EVENT_GROUP_OK;
+            OS_WaitQueueWakeTask(task);
+            woken = 1;
+        }
+        if (node == last)
+            break;
+        node = next;
+    }
+
+    eventGroup->bits &= ~clearBits;
+    return woken;
 }
@@ -59,7 +59,7 @@ OS_BufferStatus OS_FifoEnqueue(OS_tBuffer* fifo, ELEMENT_TYPE item) {
     fifo->counter++;             // Increment the counter of elements
 
     // Handle circular enqueue
-    if (fifo->tail == (((unsigned int)fifo->base + (4 * fifo->length)) - 4))
+    if (fifo->tail == (fifo->base + fifo->length - 1))
         fifo->tail = fifo->base; // Wrap the tail pointer to the start
     else
         fifo->tail++;             // Move the tail pointer forward
@@ -90,7 +90,7 @@ OS_BufferStatus OS_FifoDequeue(OS_tBuffer* fifo, ELEMENT_TYPE* item) {
     fifo->counter--;             // Decrement the counter of elements
 
     // Handle circular dequeue
-    if (fifo->head == (((unsigned int)fifo->base + (4 * fifo->length)) - 4))
+    if (fifo->head == (fifo->base + fifo->length - 1))
         fifo->head = fifo->base; // Wrap the head pointer to the start
     else
         fifo->head++;             // Move the head pointer forward
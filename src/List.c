@@ -0,0 +1,200 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Intrusive circular doubly linked list operations. Every operation except
+  the ordered and delta insertions runs in constant time.
+*/
+
+#include "List.h"
+
+/**
+ * @brief Initializes an empty list.
+ *
+ * @param List Pointer to the list to be initialized.
+ */
+void OS_ListInit(OS_List* List) {
+    List->Head = NULL;
+}
+
+/**
+ * @brief Initializes a list node and binds it to the object embedding it.
+ *
+ * @param Node Pointer to the node to be initialized.
+ * @param Owner Pointer to the object that embeds the node.
+ */
+void OS_ListNodeInit(OS_ListNode* Node, void* Owner) {
+    Node->Next = NULL;
+    Node->Prev = NULL;
+    Node->Container = NULL;      // Not linked in any list yet
+    Node->Owner = Owner;
+    Node->Value = 0;
+}
+
+/**
+ * @brief Inserts a node at the tail of a list.
+ *
+ * @param List Pointer to the list.
+ * @param Node Pointer to the node to be inserted.
+ */
+void OS_ListInsertTail(OS_List* List, OS_ListNode* Node) {
+    OS_ListNode* Head = List->Head;
+
+    if (Head == NULL) {
+        // First node links to itself
+        Node->Next = Node;
+        Node->Prev = Node;
+        List->Head = Node;
+    } else {
+        // Link between the current tail and the head
+        Node->Next = Head;
+        Node->Prev = Head->Prev;
+        Head->Prev->Next = Node;
+        Head->Prev = Node;
+    }
+
+    Node->Container = List;
+}
+
+/**
+ * @brief Inserts a node right before a given position of a list.
+ *
+ * @param List Pointer to the list.
+ * @param Node Pointer to the node to be inserted.
+ * @param Position Node of the same list to insert before, NULL to insert at the tail.
+ */
+void OS_ListInsertBefore(OS_List* List, OS_ListNode* Node, OS_ListNode* Position) {
+    if (Position == NULL) {
+        OS_ListInsertTail(List, Node);
+        return;
+    }
+
+    Node->Next = Position;
+    Node->Prev = Position->Prev;
+    Position->Prev->Next = Node;
+    Position->Prev = Node;
+    Node->Container = List;
+
+    if (Position == List->Head) {
+        List->Head = Node;       // Inserted before the first node
+    }
+}
+
+/**
+ * @brief Inserts a node keeping the list sorted by ascending Value.
+ *
+ * Nodes with an equal Value keep their insertion order (FIFO among equals).
+ *
+ * @param List Pointer to the list.
+ * @param Node Pointer to the node to be inserted, its Value must be set.
+ */
+void OS_ListInsertOrdered(OS_List* List, OS_ListNode* Node) {
+    OS_ListNode* Head = List->Head;
+    OS_ListNode* Walker;
+
+    // Empty list or not smaller than the tail: simply append
+    if ((Head == NULL) || (Node->Value >= Head->Prev->Value)) {
+        OS_ListInsertTail(List, Node);
+        return;
+    }
+
+    // Find the first node with a strictly greater value
+    Walker = Head;
+    while (Walker->Value <= Node->Value) {
+        Walker = Walker->Next;
+    }
+
+    OS_ListInsertBefore(List, Node, Walker);
+}
+
+/**
+ * @brief Inserts a node in a delta list.
+ *
+ * Each node of a delta list stores its Value relatively to its predecessor, so
+ * the absolute value of a node is the sum of the values up to it. Nodes with an
+ * equal absolute value keep their insertion order.
+ *
+ * @param List Pointer to the delta list.
+ * @param Node Pointer to the node to be inserted.
+ * @param Value Absolute value of the node (e.g. ticks to wait).
+ */
+void OS_ListInsertDelta(OS_List* List, OS_ListNode* Node, uint32_t Value) {
+    OS_ListNode* Walker = List->Head;
+    OS_ListNode* Position = NULL;
+
+    // Consume the deltas of the nodes expiring earlier (or at the same value)
+    while (Walker != NULL) {
+        if (Value < Walker->Value) {
+            Position = Walker;
+            break;
+        }
+        Value -= Walker->Value;
+        Walker = (Walker->Next == List->Head) ? NULL : Walker->Next;
+    }
+
+    Node->Value = Value;
+    OS_ListInsertBefore(List, Node, Position);
+
+    // The successor is now relative to the inserted node
+    if (Position != NULL) {
+        Position->Value -= Value;
+    }
+}
+
+/**
+ * @brief Removes a node from the list that currently holds it.
+ *
+ * @param Node Pointer to the node to be removed. Nothing is done if it is not linked.
+ */
+void OS_ListRemove(OS_ListNode* Node) {
+    OS_List* List = Node->Container;
+
+    if (List == NULL)
+        return;
+
+    if (Node->Next == Node) {
+        // Last node in the list
+        List->Head = NULL;
+    } else {
+        Node->Prev->Next = Node->Next;
+        Node->Next->Prev = Node->Prev;
+        if (List->Head == Node) {
+            List->Head = Node->Next;
+        }
+    }
+
+    Node->Next = NULL;
+    Node->Prev = NULL;
+    Node->Container = NULL;
+}
+
+/**
+ * @brief Removes a node from a delta list, handing its delta over to its successor.
+ *
+ * @param Node Pointer to the node to be removed. Nothing is done if it is not linked.
+ */
+void OS_ListRemoveDelta(OS_ListNode* Node) {
+    if (Node->Container == NULL)
+        return;
+
+    if (Node->Next != Node->Container->Head) {
+        Node->Next->Value += Node->Value;
+    }
+
+    OS_ListRemove(Node);
+}
+
+/**
+ * @brief Moves the head of a list to its tail (round robin step).
+ *
+ * @param List Pointer to the list.
+ */
+void OS_ListRotate(OS_List* List) {
+    if (List->Head != NULL) {
+        List->Head = List->Head->Next;
+    }
+}
@@ -9,6 +9,7 @@
 #include "Config.h"
 #include <MemManag.h>
 #include "Tasks.h"
+#include "Port.h"
 
 /*
  * @brief: Externed from startup code; represents the top of the stack.
@@ -26,11 +27,19 @@ extern uint32_t _estack;
  * This function sets up the initial stack frame for a task in PSP mode.
  * It pushes dummy values onto the stack, which will be used for context switching later.
  * These dummy values include the task's XPSR, PC (function pointer), LR, and registers R0-R12.
+ * With OS_STACK_PROFILING_ENABLED the whole stack is painted first, see OS_GetStackHighWaterMark.
  */
 OS_ErrorStatus OS_CreateStack(OS_TCB* Task) {
 
+#if OS_STACK_PROFILING_ENABLED
+    // Paint the stack so that the deepest word ever written can be found later
+    for (uint32_t* Word = (uint32_t*)Task->_E_PSP_Task; Word < (uint32_t*)Task->_S_PSP_Task; Word++) {
+        *Word = OS_STACK_PAINT_PATTERN;
+    }
+#endif
+
     // Set PSP (Process Stack Pointer) to the task's starting PSP.
-    Task->CurrentPSP = Task->_S_PSP_Task;
+    Task->CurrentPSP = (uint32_t*)Task->_S_PSP_Task;
 
     // XPSR (Execution Program Status Register): Set the T-bit (bit 24) for Thumb state.
     Task->CurrentPSP--;
@@ -38,7 +47,7 @@ OS_ErrorStatus OS_CreateStack(OS_TCB* Task) {
 
     // PC (Program Counter): Set to the address of the task's function.
     Task->CurrentPSP--;
-    *(Task->CurrentPSP) = (uint32_t)Task->func;
+    *(Task->CurrentPSP) = (uint32_t)(uintptr_t)Task->func;
 
     // LR (Link Register): Set to return to Thread mode and use PSP (0xFFFFFFFD).
     Task->CurrentPSP--;
@@ -66,7 +75,7 @@ OS_ErrorStatus OS_CreateMainStack() {
     OS_ErrorStatus error = OS_OK;
 
     // Main Stack Pointer (MSP) top set to the end of stack (estack).
-    OS_ControlBlock._S_MSP_Task = &_estack;
+    OS_ControlBlock._S_MSP_Task = (uintptr_t)&_estack;
 
     // Set the end of the main stack based on the main stack size.
     OS_ControlBlock._E_MSP_Task = OS_ControlBlock._S_MSP_Task - OS_MAIN_STACK_SIZE;
@@ -76,3 +85,180 @@ OS_ErrorStatus OS_CreateMainStack() {
 
     return error;
 }
+
+#if OS_STACK_PROFILING_ENABLED
+/**
+ * @brief  Measure the deepest stack use of a task since its creation.
+ *
+ * @param  Task: Pointer to the task's control block.
+ *
+ * @retval uint32_t: Maximum number of stack bytes used, StackSize if the stack is full or overflowed.
+ *
+ * @details
+ * The stack grows down from _S_PSP_Task, so the painted words left at the
+ * bottom (_E_PSP_Task) were never written. The scan stops at the first
+ * overwritten word; its cost is proportional to the unused part only.
+ * A task with a stack variable holding the pattern at its deepest point is
+ * measured a word short, which the report margin covers.
+ */
+uint32_t OS_GetStackHighWaterMark(OS_TCB* Task) {
+    uint32_t* Word = (uint32_t*)Task->_E_PSP_Task;
+    uint32_t* Top = (uint32_t*)Task->_S_PSP_Task;
+
+    while ((Word < Top) && (*Word == OS_STACK_PAINT_PATTERN)) {
+        Word++;
+    }
+
+    return (uint32_t)((uintptr_t)Top - (uintptr_t)Word);
+}
+
+/**
+ * @brief  Report the stack use of every created task with a recommended StackSize.
+ *
+ * @param  Callback: Called once per task with its high-water mark and the recommended size.
+ *
+ * @details
+ * The recommended size is the high-water mark plus OS_STACK_MARGIN_PERCENT,
+ * rounded up to 8 bytes. It is only as good as the run that produced it: let
+ * the tasks go through their worst case paths, with interrupts stacking their
+ * exception frame on the task stack, before taking the report.
+ */
+void OS_ReportStackUsage(OS_StackReportCallback Callback) {
+    for (uint8_t i = 0; i < OS_ControlBlock.NoOfCreatedTasks; i++) {
+        OS_TCB* Task = OS_ControlBlock.TaskTable[i];
+        uint32_t HighWaterMark = OS_GetStackHighWaterMark(Task);
+        uint32_t Recommended = HighWaterMark + (HighWaterMark * OS_STACK_MARGIN_PERCENT + 99) / 100;
+
+        Recommended = (Recommended + 7) & ~7UL;
+        Callback(Task, HighWaterMark, Recommended);
+    }
+}
+#endif
+
+/*
+ * Fixed-size block pools
+ * The free blocks are chained through their first word, so allocation and
+ * release pop and push the head of the list in O(1). The head and the
+ * statistics are updated with exclusive load/store instead of a critical
+ * section: unprivileged tasks cannot mask interrupts, and any exception
+ * taken between the load and the store makes the store fail and the update
+ * retry, which also protects the pop against a head freed and reallocated
+ * meanwhile (ABA). The pools are thus usable from tasks and ISRs alike.
+ */
+
+/* Adds Delta to a counter shared with ISRs and returns the new value */
+static uint32_t OS_PoolCounterAdd(volatile uint32_t* Counter, int32_t Delta) {
+    uint32_t Value;
+
+    do {
+        Value = (uint32_t)OS_LOAD_EXCLUSIVE(Counter) + (uint32_t)Delta;
+    } while (OS_STORE_EXCLUSIVE(Value, Counter));
+
+    return Value;
+}
+
+/* Raises the high-water mark to InUse if it is below */
+static void OS_PoolUpdateHighWaterMark(OS_MemPool* Pool, uint32_t InUse) {
+    do {
+        if ((uint32_t)OS_LOAD_EXCLUSIVE(&Pool->HighWaterMark) >= InUse) {
+            OS_CLEAR_EXCLUSIVE();
+            return;
+        }
+    } while (OS_STORE_EXCLUSIVE(InUse, &Pool->HighWaterMark));
+}
+
+/**
+ * @brief  Initialize a pool of fixed-size blocks.
+ *
+ * @param  Pool: Pointer to the pool to initialize.
+ * @param  Memory: Pointer aligned storage of at least OS_POOL_WORDS(BlockSize, NoOfBlocks) pointers.
+ * @param  BlockSize: Size of a block in bytes, rounded up with OS_POOL_BLOCK_SIZE.
+ * @param  NoOfBlocks: Number of blocks of the pool.
+ *
+ * @retval OS_ErrorStatus: OS_OK, or OS_INVALID_PARAMETER for a NULL or misaligned storage or an empty pool.
+ */
+OS_ErrorStatus OS_PoolInit(OS_MemPool* Pool, void* Memory, uint32_t BlockSize, uint32_t NoOfBlocks) {
+    uint8_t* Block;
+
+    if (!Memory || !BlockSize || !NoOfBlocks || ((uintptr_t)Memory % sizeof(void*)))
+        return OS_INVALID_PARAMETER;
+
+    Pool->BlockSize = OS_POOL_BLOCK_SIZE(BlockSize);
+    Pool->NoOfBlocks = NoOfBlocks;
+    Pool->Start = (uint8_t*)Memory;
+    Pool->End = Pool->Start + Pool->BlockSize * NoOfBlocks;
+    Pool->InUse = 0;
+    Pool->HighWaterMark = 0;
+    Pool->Failures = 0;
+
+    // Chain the blocks in address order
+    Pool->FreeList = NULL;
+    for (Block = Pool->End - Pool->BlockSize; Block >= Pool->Start; Block -= Pool->BlockSize) {
+        ((OS_PoolBlock*)Block)->Next = Pool->FreeList;
+        Pool->FreeList = (OS_PoolBlock*)Block;
+        if (Block == Pool->Start)
+            break;
+    }
+
+    return OS_OK;
+}
+
+/**
+ * @brief  Allocate a block from a pool in constant time, never blocks.
+ *
+ * @param  Pool: Pointer to the pool.
+ *
+ * @retval void*: The block, or NULL if the pool is empty (counted in the failures).
+ */
+void* OS_PoolAlloc(OS_MemPool* Pool) {
+    OS_PoolBlock* Block;
+
+    do {
+        Block = (OS_PoolBlock*)(uintptr_t)OS_LOAD_EXCLUSIVE(&Pool->FreeList);
+        if (Block == NULL) {
+            OS_CLEAR_EXCLUSIVE();
+            OS_PoolCounterAdd(&Pool->Failures, 1);
+            return NULL;
+        }
+    } while (OS_STORE_EXCLUSIVE(Block->Next, &Pool->FreeList));
+
+    OS_PoolUpdateHighWaterMark(Pool, OS_PoolCounterAdd(&Pool->InUse, 1));
+
+    return Block;
+}
+
+/**
+ * @brief  Return a block to its pool in constant time.
+ *
+ * @param  Pool: Pointer to the pool the block was allocated from.
+ * @param  Block: Block returned by OS_PoolAlloc.
+ *
+ * @retval OS_ErrorStatus: OS_OK, or OS_INVALID_PARAMETER if the block does not belong to the pool.
+ */
+OS_ErrorStatus OS_PoolFree(OS_MemPool* Pool, void* Block) {
+    OS_PoolBlock* Freed = (OS_PoolBlock*)Block;
+
+    if (((uint8_t*)Block < Pool->Start) || ((uint8_t*)Block >= Pool->End) ||
+        (((uint8_t*)Block - Pool->Start) % Pool->BlockSize))
+        return OS_INVALID_PARAMETER;
+
+    do {
+        Freed->Next = (OS_PoolBlock*)(uintptr_t)OS_LOAD_EXCLUSIVE(&Pool->FreeList);
+    } while (OS_STORE_EXCLUSIVE(Freed, &Pool->FreeList));
+
+    OS_PoolCounterAdd(&Pool->InUse, -1);
+
+    return OS_OK;
+}
+
+/**
+ * @brief  Read the statistics of a pool.
+ *
+ * @param  Pool: Pointer to the pool.
+ * @param  Stats: Receives the blocks in use, the high-water mark and the failed allocations.
+ */
+void OS_PoolGetStats(OS_MemPool* Pool, OS_MemPoolStats* Stats) {
+    Stats->InUse = Pool->InUse;
+    Stats->HighWaterMark = Pool->HighWaterMark;
+    Stats->Failures = Pool->Failures;
+}
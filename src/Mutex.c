@@ -7,10 +7,54 @@
 
   Description:
   Implementation of Mutex functions for task synchronization in an RTOS.
+  Acquire and release run as kernel services. With OS_MUTEX_PRIORITY_INHERITANCE
+  the owner of a mutex runs at the priority of its highest priority waiter,
+  along the whole chain of owners blocked on further mutexes.
 */
 
 #include "Mutex.h"
-#include "FIFO.h"
+#include "Port.h"
+#include "Trace.h"
+
+/**
+ * @brief Returns the priority a task must run at: its base priority raised to the
+ * highest priority waiting on any mutex it still holds.
+ *
+ * @param task Pointer to the task.
+ * @return uint8_t The effective priority.
+ */
+static uint8_t OS_MutexInheritedPriority(OS_TCB* task) {
+    uint8_t priority = task->BasePriority;
+#if OS_MUTEX_PRIORITY_INHERITANCE
+    OS_ListNode* node = task->HeldMutexes.Head;
+
+    if (node == NULL)
+        return priority;
+
+    do {
+        OS_ListNode* waiter = ((OS_Mutex*)node->Owner)->waiters.Tasks.Head;
+
+        // Mutex wait queues are priority ordered, their head is the highest priority waiter
+        if ((waiter != NULL) && (waiter->Value < priority)) {
+            priority = (uint8_t)waiter->Value;
+        }
+        node = node->Next;
+    } while (node != task->HeldMutexes.Head);
+#endif
+    return priority;
+}
+
+/**
+ * @brief Gives the mutex to a task.
+ *
+ * @param mutex Pointer to the mutex.
+ * @param task Pointer to the new owner.
+ */
+static void OS_MutexSetOwner(OS_Mutex* mutex, OS_TCB* task) {
+    mutex->isLocked = 1;
+    mutex->owner = task;
+    OS_ListInsertTail(&task->HeldMutexes, &mutex->heldLink);
+}
 
 /**
  * @brief Initializes a mutex.
@@ -23,7 +67,8 @@ OS_MutexState OS_InitMutex(OS_Mutex* mutex) {
     mutex->waitingCount = 0;
     mutex->owner = NULL;
 
-    OS_FifoInit(&(mutex->waitingQueue), mutex->waitingQueueBuffer, 100);
+    OS_WaitQueueInit(&mutex->waiters, OS_WAIT_PRIORITY);
+    OS_ListNodeInit(&mutex->heldLink, mutex);
 
     return OS_MUTEX_INIT_OK;
 }
@@ -34,22 +79,18 @@ OS_MutexState OS_InitMutex(OS_Mutex* mutex) {
  * @param mutex Pointer to the mutex.
  * @param task Pointer to the task attempting to acquire the mutex.
  * @return OS_MutexState The result of the acquire attempt (e.g., OS_MUTEX_AVAILABLE, OS_MUTEX_BUSY).
+ *         OS_MUTEX_BUSY is returned once the task owns the mutex after having been blocked.
  */
 OS_MutexState OS_AcquireMutex(OS_Mutex* mutex, OS_TCB* task) {
-    if (mutex->isLocked && task == mutex->owner) {
-        return OS_MUTEX_ALREADY_ACQUIRED;  // Task already owns the mutex
-    }
+    OS_MutexRequest request;
 
-    if (mutex->isLocked) {
-        mutex->waitingCount++;
-        OS_FifoEnqueue(&(mutex->waitingQueue), task);
-        OS_TerminateTask(task);  // Block the task until mutex is available
-        return OS_MUTEX_BUSY;
-    } else {
-        mutex->isLocked = 1;  // Lock the mutex
-        mutex->owner = task;   // Set the owner of the mutex
-        return OS_MUTEX_AVAILABLE;
-    }
+    request.mutex = mutex;
+    request.task = task;
+
+    // Block the task in the kernel until the mutex is available
+    OS_REQUEST_SERVICE_ARG(SVC_ACQUIRE_MUTEX, &request);
+
+    return request.state;
 }
 
 /**
@@ -59,22 +100,139 @@ OS_MutexState OS_AcquireMutex(OS_Mutex* mutex, OS_TCB* task) {
  * @return OS_MutexState The result of the release operation (OS_MUTEX_AVAILABLE).
  */
 OS_MutexState OS_ReleaseMutex(OS_Mutex* mutex) {
-	OS_TCB* dequeuedTask;
+    OS_MutexRequest request;
+
+    request.mutex = mutex;
+    request.task = NULL;
+
+    // Hand the mutex to the next waiter and restore the owner priority in the kernel
+    OS_REQUEST_SERVICE_ARG(SVC_RELEASE_MUTEX, &request);
+
+    return request.state;
+}
+
+/**
+ * @brief Kernel side of OS_AcquireMutex.
+ *
+ * A busy mutex queues the task by priority and, with priority inheritance, raises
+ * the owner to the task priority, then the owner of the mutex the owner is blocked
+ * on, and so on along the chain.
+ *
+ * @param request Acquire arguments, the state is written back.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_MutexAcquireService(OS_MutexRequest* request) {
+    OS_Mutex* mutex = request->mutex;
+    OS_TCB* task = request->task;
+    OS_TCB* owner;
+
+    if (mutex->isLocked && task == mutex->owner) {
+        request->state = OS_MUTEX_ALREADY_ACQUIRED;  // Task already owns the mutex
+        return 0;
+    }
+
+    if (!mutex->isLocked) {
+        OS_MutexSetOwner(mutex, task);
+        request->state = OS_MUTEX_AVAILABLE;
+        return 0;
+    }
+
+    // Queue the task by priority, FIFO among equal priorities
+    OS_TRACE(OS_TRACE_MUTEX_CONTENDED, task, OS_TRACE_TASK_ID(mutex->owner));
+    mutex->waitingCount++;
+    task->WaitMutex = mutex;
+    OS_WaitQueueBlock(&mutex->waiters, task, request, OS_WAIT_FOREVER);
+
+#if OS_MUTEX_PRIORITY_INHERITANCE
+    // Propagate the priority along the chain of owners
+    owner = mutex->owner;
+    while ((owner != NULL) && (task->Priority < owner->Priority)) {
+        OS_ChangeTaskPriority(owner, task->Priority);
+        owner = (owner->WaitMutex != NULL) ? owner->WaitMutex->owner : NULL;
+    }
+#else
+    (void)owner;
+#endif
+
+    request->state = OS_MUTEX_BUSY;
+    return 1;
+}
+
+/**
+ * @brief Kernel side of OS_ReleaseMutex.
+ *
+ * The owner drops back to the highest priority still required by the mutexes it
+ * holds, and the highest priority waiter becomes the new owner.
+ *
+ * @param request Release arguments, the state is written back.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_MutexReleaseService(OS_MutexRequest* request) {
+    OS_Mutex* mutex = request->mutex;
+    OS_TCB* owner = mutex->owner;
+    OS_TCB* next;
+    uint8_t priority;
+    uint8_t reschedule;
+
+    request->state = OS_MUTEX_AVAILABLE;
 
     if (!mutex->isLocked) {
-        return OS_MUTEX_AVAILABLE;  // Mutex is already available
+        return 0;  // Mutex is already available
     }
 
+    OS_ListRemove(&mutex->heldLink);
     mutex->isLocked = 0;  // Unlock the mutex
-    if (mutex->waitingCount > 0) {
-        mutex->waitingCount--;
-        OS_FifoDequeue(&(mutex->waitingQueue), &dequeuedTask);
-        mutex->owner = dequeuedTask;
-        mutex->isLocked = 1;  // Lock the mutex for the new owner
-        OS_ActivateTask(dequeuedTask);  // Wake up the next task in queue
-    } else {
-        mutex->owner = NULL;  // No tasks waiting, release ownership
+    mutex->owner = NULL;  // No tasks waiting, release ownership
+
+    priority = OS_MutexInheritedPriority(owner);
+    reschedule = (priority != owner->Priority);
+    OS_ChangeTaskPriority(owner, priority);
+
+    // Wake up the highest priority waiter as the new owner
+    next = OS_WaitQueueWake(&mutex->waiters);
+    if (next == NULL) {
+        return reschedule;
     }
 
-    return OS_MUTEX_AVAILABLE;
+    mutex->waitingCount--;
+    next->WaitMutex = NULL;
+    OS_MutexSetOwner(mutex, next);
+    OS_ChangeTaskPriority(next, OS_MutexInheritedPriority(next));
+
+    return 1;
+}
+
+/**
+ * @brief Withdraws a blocked task from the mutex it waits for (kernel services only).
+ *
+ * Called when the task is terminated or activated again while blocked. With
+ * priority inheritance, the owners along the chain drop the priority they may
+ * have inherited from it.
+ *
+ * @param task Pointer to the task, its WaitMutex is set.
+ */
+void OS_MutexWaitCancel(OS_TCB* task) {
+    OS_Mutex* mutex = task->WaitMutex;
+    OS_TCB* owner;
+    uint8_t priority;
+
+    OS_WaitQueueRemove(task);
+    mutex->waitingCount--;
+    task->WaitMutex = NULL;
+
+#if OS_MUTEX_PRIORITY_INHERITANCE
+    // Stops at the first owner left unchanged: nothing further up the chain can
+    // change either, and a deadlock cycle is not walked around forever
+    owner = mutex->owner;
+    while (owner != NULL) {
+        priority = OS_MutexInheritedPriority(owner);
+        if (priority == owner->Priority)
+            break;
+        OS_ChangeTaskPriority(owner, priority);
+        owner = (owner->WaitMutex != NULL) ? owner->WaitMutex->owner : NULL;
+    }
+#else
+    (void)owner;
+    (void)priority;
+#endif
 }
@@ -19,8 +19,19 @@
 
 
 
+/* SysTick counts per OS tick */
+#define OS_SYSTICK_COUNT_PER_TICK   ((OS_CPU_CLOCK_FREQ_IN_HZ / 1000) * OS_TICK_TIME_IN_MS)
+
 uint8_t SystickLed;
 
+#if OS_TICKLESS_IDLE_ENABLED
+/* Longest idle period the 24-bit SysTick reload can cover, in ticks */
+#define OS_TICKLESS_MAX_TICKS       (SysTick_LOAD_RELOAD_Msk / OS_SYSTICK_COUNT_PER_TICK)
+
+static volatile uint8_t TicklessActive;    // SysTick currently runs a stretched period
+static uint32_t TicklessExpectedTicks;     // Ticks covered by the stretched period
+#endif
+
 /* FAULT HANDLERS : Useful for debugging */
 void NMI_Handler(void) {
     while (1) {}
@@ -44,16 +55,40 @@ void UsageFault_Handler(void) {
 
 /* SysTick Handler for OS tick update and context switching */
 void SysTick_Handler(void) {
+#if OS_PROFILING_ENABLED
+	uint32_t StartCycles = OS_GET_CYCLE_COUNT();
+#endif
+	uint32_t Interrupts;
 	SystickLed ^= 1;       // Toggle the SysTick LED to visually verify operation
+	/* Interrupts calling the FromISR services must not see the kernel state half updated */
+	Interrupts = OS_EnterCriticalFromISR();
+#if OS_TICKLESS_IDLE_ENABLED
+	if (TicklessActive) {
+		/* End of a stretched period: this handler processes its last tick */
+		TicklessActive = 0;
+		OS_StepTickCount(TicklessExpectedTicks - 1);
+	}
+#endif
 	OS_UpdateNoOfTicks();           // Update the OS tick count
+	OS_ExitCriticalFromISR(Interrupts);
 #if OS_TICK_HOOK_ENABLED
 	if (SysTickHook != NULL) {
 	    SysTickHook();           // Call the SysTick hook, if registered
 	}
 #endif
+	Interrupts = OS_EnterCriticalFromISR();
 	OS_DecideNext();                // Determine the next task to run
 #if OS_PREEMPTION_ENABLED
-    OS_TRIGGER_PENDSV();   // Trigger PendSV only if preemption is enabled
+	if (OS_SwitchRequired()) {
+	    OS_TRIGGER_PENDSV();   // Trigger PendSV only if preemption is enabled and the task changes
+	}
+#endif
+	OS_ExitCriticalFromISR(Interrupts);
+#if OS_PROFILING_ENABLED
+	OS_ProfileData.TickLastCycles = OS_GET_CYCLE_COUNT() - StartCycles;
+	if (OS_ProfileData.TickLastCycles > OS_ProfileData.TickMaxCycles) {
+		OS_ProfileData.TickMaxCycles = OS_ProfileData.TickLastCycles;
+	}
 #endif
 }
             // Trigger PendSV for context switching
@@ -75,72 +110,140 @@ __attribute ((naked)) void SVC_Handler(void) {
 void OS_HwInit() {
     /* Set PendSV priority to match SysTick priority */
     __NVIC_SetPriority(PendSV_IRQn, 15);
+
+    /* SVC runs just above the kernel interrupt band: the band cannot preempt a service,
+     * the interrupts above it are never delayed by the kernel */
+    __NVIC_SetPriority(SVCall_IRQn, OS_KERNEL_INTERRUPT_PRIORITY - 1);
+
+#if OS_PROFILING_ENABLED || OS_RUNTIME_STATS_ENABLED || OS_TRACE_ENABLED
+    /* Start the cycle counter used by the kernel measurements */
+    OS_CYCLE_COUNTER_INIT();
+#endif
 }
 
 /* Start OS timer for scheduling */
 void OS_StartTimer() {
     /* SysTick setup: 72 MHz CPU clock, 1ms tick (72000 counts) */
-	uint32_t Count = (OS_CPU_CLOCK_FREQ_IN_HZ / 1000) * OS_TICK_TIME_IN_MS;
+	uint32_t Count = OS_SYSTICK_COUNT_PER_TICK;
     SysTick_Config(Count);
 }
 
+#if OS_TICKLESS_IDLE_ENABLED
+/* Stretch the SysTick period to cover several ticks (called from the SVC handler)
+ * The reload covers the rest of the current tick plus the following full ticks.
+ */
+void OS_TicklessEnter(uint32_t ExpectedIdleTicks) {
+	uint32_t Reload;
+
+	if (ExpectedIdleTicks > OS_TICKLESS_MAX_TICKS) {
+		ExpectedIdleTicks = OS_TICKLESS_MAX_TICKS;
+	}
+
+	/* Stop the counter while it is reprogrammed */
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+	/* A tick is already pending: let it be processed normally */
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		return;
+	}
+
+	Reload = SysTick->VAL + (OS_SYSTICK_COUNT_PER_TICK * (ExpectedIdleTicks - 1));
+	SysTick->LOAD = Reload;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+	/* The stretched period is loaded, the following reload is a normal tick again */
+	SysTick->LOAD = OS_SYSTICK_COUNT_PER_TICK - 1;
+
+	TicklessExpectedTicks = ExpectedIdleTicks;
+	TicklessActive = 1;
+}
+
+/* Leave a stretched period early (another interrupt woke the CPU)
+ * The complete ticks slept are accounted and SysTick is realigned on the tick in progress.
+ * Called by every FromISR critical section; SysTick_Handler ends the period itself.
+ */
+void OS_TicklessExit() {
+	uint32_t Ctrl;
+	uint32_t Elapsed;
+	uint32_t CompleteTicks;
+
+	if (!TicklessActive || ((SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) == ((uint32_t)SysTick_IRQn + 16U)))
+		return;
+
+	/* Stop the counter, reading CTRL also returns (and clears) COUNTFLAG */
+	Ctrl = SysTick->CTRL;
+	SysTick->CTRL = Ctrl & ~SysTick_CTRL_ENABLE_Msk;
+
+	/* The stretched period already ended: SysTick_Handler accounts for it */
+	if ((Ctrl & SysTick_CTRL_COUNTFLAG_Msk) || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)) {
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		return;
+	}
+
+	/* Counts elapsed since the last processed tick */
+	Elapsed = (TicklessExpectedTicks * OS_SYSTICK_COUNT_PER_TICK) - SysTick->VAL;
+	CompleteTicks = Elapsed / OS_SYSTICK_COUNT_PER_TICK;
+	OS_StepTickCount(CompleteTicks);
+
+	/* Next interrupt at the end of the tick in progress, then normal ticks again */
+	SysTick->LOAD = ((CompleteTicks + 1) * OS_SYSTICK_COUNT_PER_TICK) - Elapsed;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	SysTick->LOAD = OS_SYSTICK_COUNT_PER_TICK - 1;
+
+	TicklessActive = 0;
+}
+#endif
+
 /* PendSV Handler for context switching between tasks
- * Handles saving and restoring task contexts (PSP, registers R4-R11)
+ * Saves R4-R11 of the current task on its PSP with one STMDB, restores the next
+ * task with one LDMIA, and keeps &OS_ControlBlock and both TCB pointers in registers.
+ * When the scheduler selected the running task again nothing is saved or restored.
+ * With OS_SWITCH_HOOK_ENABLED the switch is accounted before the context is saved.
+ * PendSV has the lowest priority, so the kernel band is masked through BASEPRI
+ * from the NextTask load to the PSP restore: a FromISR service or the tick cannot
+ * select a task in between and have its decision overwritten.
  */
 __attribute((naked)) void PendSV_Handler(void)
 {
-	/* Context Switching */
-	/* Save the context of current */
-	if (OS_ControlBlock.NextTask != NULL){
-		/* 1- Get current PSP
-		 * the returned PSP is after the CPU pushes XPSR, LR, PC, R0->R3,R12 */
-		OS_GET_PSP(OS_ControlBlock.CurrentTask->CurrentPSP);
-		/* 2- Push R4-> R11 manually */
-		OS_ControlBlock.CurrentTask->CurrentPSP--;
-		__asm volatile("MOV %0 , R4":"=r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP--;
-		__asm volatile("MOV %0 , R5":"=r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP--;
-		__asm volatile("MOV %0 , R6":"=r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP--;
-		__asm volatile("MOV %0 , R7":"=r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP--;
-		__asm volatile("MOV %0 , R8":"=r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP--;
-		__asm volatile("MOV %0 , R9":"=r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP--;
-		__asm volatile("MOV %0 , R10":"=r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP--;
-		__asm volatile("MOV %0 , R11":"=r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-
-		/* Restore the context of current */
-
-		OS_ControlBlock.CurrentTask = OS_ControlBlock.NextTask;
-		OS_ControlBlock.NextTask = 	NULL;
-		/* The last value of the CurrentPSP of the current task is that is
-		 * pointing to R11 */
-		/* 1- Restore manually pushed registers */
-
-		__asm volatile("MOV R11 , %0"::"r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP++;
-		__asm volatile("MOV R10 , %0"::"r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP++;
-		__asm volatile("MOV R9 , %0"::"r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP++;
-		__asm volatile("MOV R8 , %0"::"r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP++;
-		__asm volatile("MOV R7 , %0"::"r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP++;
-		__asm volatile("MOV R6 , %0"::"r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP++;
-		__asm volatile("MOV R5 , %0"::"r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP++;
-		__asm volatile("MOV R4 , %0"::"r"(*(OS_ControlBlock.CurrentTask->CurrentPSP)));
-		OS_ControlBlock.CurrentTask->CurrentPSP++;
-
-		/* 2- Set PSP to the the task */
-		OS_SET_PSP(OS_ControlBlock.CurrentTask->CurrentPSP);
-		/* Now the CPU can restore automatically */
-	}
-	__asm volatile("BX LR");
+	__asm volatile(
+		"MOVW  R0, #:lower16:OS_ControlBlock   \n\t"
+		"MOVT  R0, #:upper16:OS_ControlBlock   \n\t"
+		"MOV   R3, %[Mask]                     \n\t"
+		"MSR   BASEPRI, R3                     \n\t"   /* Mask the kernel interrupt band */
+		"LDR   R2, [R0, %[Next]]               \n\t"   /* R2 = NextTask */
+		"CBZ   R2, 1f                          \n\t"   /* No task selected */
+		"MOVS  R3, #0                          \n\t"
+		"STR   R3, [R0, %[Next]]               \n\t"   /* NextTask = NULL */
+		"LDR   R1, [R0, %[Current]]            \n\t"   /* R1 = CurrentTask */
+		"CMP   R1, R2                          \n\t"
+		"BEQ   1f                              \n\t"   /* Same task: fast return */
+#if OS_SWITCH_HOOK_ENABLED
+		"PUSH  {R0-R2, LR}                     \n\t"
+		"MOV   R0, R1                          \n\t"
+		"MOV   R1, R2                          \n\t"
+		"BL    OS_TaskSwitched                 \n\t"   /* OS_TaskSwitched(CurrentTask, NextTask) */
+		"POP   {R0-R2, LR}                     \n\t"
+#endif
+		/* Save the context of the current task, the CPU already pushed R0-R3, R12, LR, PC, xPSR */
+		"MRS   R3, PSP                         \n\t"
+		"STMDB R3!, {R4-R11}                   \n\t"
+		"STR   R3, [R1, %[PSP]]                \n\t"
+		/* Restore the context of the next task */
+		"STR   R2, [R0, %[Current]]            \n\t"   /* CurrentTask = NextTask */
+		"LDR   R3, [R2, %[PSP]]                \n\t"
+		"LDMIA R3!, {R4-R11}                   \n\t"
+		"MSR   PSP, R3                         \n\t"   /* The CPU restores the rest on return */
+		"1:                                    \n\t"
+		"MOVS  R3, #0                          \n\t"
+		"MSR   BASEPRI, R3                     \n\t"   /* Unmask before returning */
+		"BX    LR                              \n\t"
+		:
+		: [Mask] "i" (OS_KERNEL_BASEPRI),
+		  [Current] "i" (offsetof(OS_Control, Cores[0].CurrentTask)),
+		  [Next] "i" (offsetof(OS_Control, Cores[0].NextTask)),
+		  [PSP] "i" (offsetof(OS_TCB, CurrentPSP))
+	);
 }
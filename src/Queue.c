@@ -0,0 +1,247 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Zero-copy message queues with blocking send and receive.
+  The messages are kept in a circular buffer handled like the FIFOs of FIFO.c.
+  A message sent while a receiver is blocked goes straight to that receiver,
+  and a message received while a sender is blocked pulls that sender's message
+  into the buffer, so a woken task never has to retry.
+*/
+
+#include "Queue.h"
+#include "Port.h"
+
+/* Appends a message at the tail of the circular buffer */
+static void OS_QueuePut(OS_Queue* queue, void* message) {
+    *(queue->tail) = message;
+    queue->counter++;
+
+    // Handle circular enqueue
+    if (queue->tail == (queue->base + queue->length - 1))
+        queue->tail = queue->base;
+    else
+        queue->tail++;
+}
+
+/* Removes the message at the head of the circular buffer */
+static void* OS_QueueGet(OS_Queue* queue) {
+    void* message = *(queue->head);
+    queue->counter--;
+
+    // Handle circular dequeue
+    if (queue->head == (queue->base + queue->length - 1))
+        queue->head = queue->base;
+    else
+        queue->head++;
+
+    return message;
+}
+
+/**
+ * @brief Initializes a message queue.
+ *
+ * @param queue Pointer to the queue to be initialized.
+ * @param buffer Storage for length message pointers.
+ * @param length Capacity of the queue in messages (1 for a mailbox).
+ * @param order Order in which blocked senders and receivers are served (OS_WAIT_FIFO or OS_WAIT_PRIORITY).
+ * @return OS_QueueState OS_QUEUE_INIT_OK, or OS_QUEUE_INIT_ERROR for a NULL buffer or a zero length.
+ */
+OS_QueueState OS_InitQueue(OS_Queue* queue, void** buffer, uint32_t length, OS_WaitOrder order) {
+    if (!buffer || !length)
+        return OS_QUEUE_INIT_ERROR;
+
+    queue->base = buffer;
+    queue->head = buffer;
+    queue->tail = buffer;
+    queue->length = length;
+    queue->counter = 0;
+
+    OS_WaitQueueInit(&queue->senders, order);
+    OS_WaitQueueInit(&queue->receivers, order);
+
+    return OS_QUEUE_INIT_OK;
+}
+
+/**
+ * @brief Sends a message, handing the buffer it points to over to the receiver.
+ *
+ * @param queue Pointer to the queue.
+ * @param message Pointer to send, the sender must not touch the buffer afterwards.
+ * @param timeout Ticks to wait for room, 0 to return at once or OS_WAIT_FOREVER.
+ * @return OS_QueueState OS_QUEUE_OK, OS_QUEUE_FULL (no wait) or OS_QUEUE_TIMEOUT.
+ */
+OS_QueueState OS_QueueSend(OS_Queue* queue, void* message, uint32_t timeout) {
+    OS_QueueRequest request;
+
+    request.queue = queue;
+    request.task = OS_GetCurrentTask();
+    request.message = message;
+    request.timeout = timeout;
+    request.state = OS_QUEUE_TIMEOUT;
+
+    OS_REQUEST_SERVICE_ARG(SVC_QUEUE_SEND, &request);
+
+    if (request.state == OS_QUEUE_BLOCKED) {
+        // Woken up without room (timeout): stop waiting
+        OS_REQUEST_SERVICE_ARG(SVC_QUEUE_SEND, &request);
+    }
+
+    return request.state;
+}
+
+/**
+ * @brief Sends a message from an interrupt handler, without waiting.
+ *
+ * The kernel state is updated directly in a critical section; a woken receiver
+ * of higher priority runs as soon as the interrupt returns.
+ *
+ * @param queue Pointer to the queue.
+ * @param message Pointer to send, the sender must not touch the buffer afterwards.
+ * @return OS_QueueState OS_QUEUE_OK or OS_QUEUE_FULL.
+ */
+OS_QueueState OS_QueueSendFromISR(OS_Queue* queue, void* message) {
+    OS_QueueRequest request;
+    uint32_t interrupts;
+
+    request.queue = queue;
+    request.task = NULL;
+    request.message = message;
+    request.timeout = 0;
+    request.state = OS_QUEUE_TIMEOUT;
+
+    interrupts = OS_EnterCriticalFromISR();
+    if (OS_QueueSendService(&request)) {
+        OS_RescheduleFromISR();
+    }
+    OS_ExitCriticalFromISR(interrupts);
+
+    return request.state;
+}
+
+/**
+ * @brief Receives a message, the receiver becomes the owner of the buffer.
+ *
+ * @param queue Pointer to the queue.
+ * @param message Receives the pointer sent.
+ * @param timeout Ticks to wait for a message, 0 to return at once or OS_WAIT_FOREVER.
+ * @return OS_QueueState OS_QUEUE_OK, OS_QUEUE_EMPTY (no wait) or OS_QUEUE_TIMEOUT.
+ */
+OS_QueueState OS_QueueReceive(OS_Queue* queue, void** message, uint32_t timeout) {
+    OS_QueueRequest request;
+
+    request.queue = queue;
+    request.task = OS_GetCurrentTask();
+    request.message = NULL;
+    request.timeout = timeout;
+    request.state = OS_QUEUE_TIMEOUT;
+
+    OS_REQUEST_SERVICE_ARG(SVC_QUEUE_RECEIVE, &request);
+
+    if (request.state == OS_QUEUE_BLOCKED) {
+        // Woken up without a message (timeout): stop waiting
+        OS_REQUEST_SERVICE_ARG(SVC_QUEUE_RECEIVE, &request);
+    }
+
+    *message = request.message;
+    return request.state;
+}
+
+/**
+ * @brief Kernel side of OS_QueueSend.
+ *
+ * @param request Send arguments, the state is written back.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_QueueSendService(OS_QueueRequest* request) {
+    OS_Queue* queue = request->queue;
+    OS_TCB* receiver;
+
+    // Already completed by a receiver while the caller was waking up
+    if (request->state == OS_QUEUE_OK)
+        return 0;
+
+    // Second call of a blocked sender: the timeout expired
+    if (request->state == OS_QUEUE_BLOCKED) {
+        OS_WaitQueueRemove(request->task);
+        request->state = OS_QUEUE_TIMEOUT;
+        return 0;
+    }
+
+    // A blocked receiver means an empty queue: hand the message over directly
+    receiver = OS_WaitQueueWake(&queue->receivers);
+    if (receiver != NULL) {
+        OS_QueueRequest* pending = (OS_QueueRequest*)receiver->WaitRequest;
+
+        pending->message = request->message;
+        pending->state = OS_QUEUE_OK;
+        request->state = OS_QUEUE_OK;
+        return 1;
+    }
+
+    if (queue->counter < queue->length) {
+        OS_QueuePut(queue, request->message);
+        request->state = OS_QUEUE_OK;
+        return 0;
+    }
+
+    if (request->timeout == 0) {
+        request->state = OS_QUEUE_FULL;
+        return 0;
+    }
+
+    request->state = OS_QUEUE_BLOCKED;
+    OS_WaitQueueBlock(&queue->senders, request->task, request, request->timeout);
+    return 1;
+}
+
+/**
+ * @brief Kernel side of OS_QueueReceive.
+ *
+ * @param request Receive arguments, the message and state are written back.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_QueueReceiveService(OS_QueueRequest* request) {
+    OS_Queue* queue = request->queue;
+    OS_TCB* sender;
+
+    // Already completed by a sender while the caller was waking up
+    if (request->state == OS_QUEUE_OK)
+        return 0;
+
+    // Second call of a blocked receiver: the timeout expired
+    if (request->state == OS_QUEUE_BLOCKED) {
+        OS_WaitQueueRemove(request->task);
+        request->state = OS_QUEUE_TIMEOUT;
+        return 0;
+    }
+
+    if (queue->counter > 0) {
+        request->message = OS_QueueGet(queue);
+        request->state = OS_QUEUE_OK;
+
+        // A blocked sender means the queue was full: its message takes the freed slot
+        sender = OS_WaitQueueWake(&queue->senders);
+        if (sender != NULL) {
+            OS_QueueRequest* pending = (OS_QueueRequest*)sender->WaitRequest;
+
+            OS_QueuePut(queue, pending->message);
+            pending->state = OS_QUEUE_OK;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (request->timeout == 0) {
+        request->state = OS_QUEUE_EMPTY;
+        return 0;
+    }
+
+    request->state = OS_QUEUE_BLOCKED;
+    OS_WaitQueueBlock(&queue->receivers, request->task, request, request->timeout);
+    return 1;
+}
@@ -7,15 +7,21 @@
 
   Description:
   Handling Semaphore operations like acquire and release.
+  Acquire and release run as kernel services, the blocked tasks are linked
+  in the semaphore wait queue through their TCB.
 */
 
 #include "Semaphore.h"
+#include "Port.h"
+#include "Trace.h"
 
 /**
  * @brief Initializes a semaphore.
  *
  * This function initializes the semaphore with an initial count,
  * sets the waiting count to zero, and clears the owner.
+ * A semaphore created with a count of 0 is a signal: its units are produced by
+ * releases (typically from ISRs) and consumed by acquires, no owner is tracked.
  *
  * @param semaphore Pointer to the OS_Semaphore structure to be initialized.
  * @param initialCount The initial count of the semaphore.
@@ -25,9 +31,10 @@ OS_SemaphoreState OS_InitSemaphore(OS_Semaphore* semaphore, uint8_t initialCount
     semaphore->count = initialCount;           // Set the initial count of the semaphore
     semaphore->waitingCount = 0;               // Initialize the waiting count to zero
     semaphore->owner = NULL;                    // Set the owner to NULL
+    semaphore->isSignal = (initialCount == 0);  // Nothing to hand back: releases signal events
 
     // Initialize the waiting queue for tasks
-    OS_FifoInit(&(semaphore->waitingQueue), semaphore->waitingQueueBuffer, 100);
+    OS_WaitQueueInit(&semaphore->waiters, OS_WAIT_FIFO);
 
     return OS_SEMAPHORE_INIT_OK;               // Indicate successful initialization
 }
@@ -38,49 +45,145 @@ OS_SemaphoreState OS_InitSemaphore(OS_Semaphore* semaphore, uint8_t initialCount
  * This function attempts to acquire the semaphore. If the semaphore
  * is already acquired by the calling task, it returns an error.
  * If the semaphore is busy and the calling task is not the owner,
- * the task is added to the waiting queue and terminated.
+ * the task is blocked in the waiting queue until a release hands it the semaphore.
  *
  * @param semaphore Pointer to the OS_Semaphore structure to acquire.
  * @param task Pointer to the OS_TCB structure of the task attempting to acquire the semaphore.
  * @return OS_SemaphoreState Status of the semaphore acquisition.
+ *         OS_SEMAPHORE_BUSY is returned once the task owns the semaphore after having been blocked.
  */
 OS_SemaphoreState OS_AcquireSemaphore(OS_Semaphore* semaphore, OS_TCB* task) {
-    semaphore->count--;  // Decrement the semaphore count
-    if (task == semaphore->owner) {
-        return OS_SEMAPHORE_ALREADY_ACQUIRED;  // Return error if the task is already the owner
-    }
-    if (semaphore->count < 0 && semaphore->owner) {
-        // If the semaphore is busy and owned, add the task to the waiting queue
-        semaphore->waitingCount++;
-        OS_FifoEnqueue(&(semaphore->waitingQueue), task); // Enqueue the task
-        OS_TerminateTask(task);  // Terminate the task since it can't proceed
-        return OS_SEMAPHORE_BUSY; // Indicate the semaphore is busy
-    } else {
-        semaphore->owner = task; // Set the current task as the owner
-    }
-    return OS_SEMAPHORE_AVAILABLE; // Indicate the semaphore is available
+    OS_SemaphoreRequest request;
+
+    request.semaphore = semaphore;
+    request.task = task;
+
+    // Block the task in the kernel until the semaphore is available
+    OS_REQUEST_SERVICE_ARG(SVC_ACQUIRE_SEMAPHORE, &request);
+
+    return request.state;
 }
 
 /**
  * @brief Releases a semaphore.
  *
  * This function releases the semaphore, increments its count,
- * and if there are tasks waiting for the semaphore, it dequeues
- * one and activates it.
+ * and if there are tasks waiting for the semaphore, it hands
+ * the semaphore to the first one.
  *
  * @param semaphore Pointer to the OS_Semaphore structure to release.
  * @return OS_SemaphoreState Status of the semaphore release.
  */
 OS_SemaphoreState OS_ReleaseSemaphore(OS_Semaphore* semaphore) {
-    OS_TCB* dequeuedTask; // Variable to hold the task that will be dequeued
+    OS_SemaphoreRequest request;
+
+    request.semaphore = semaphore;
+    request.task = NULL;
+
+    // Hand the semaphore to the next waiter in the kernel
+    OS_REQUEST_SERVICE_ARG(SVC_RELEASE_SEMAPHORE, &request);
+
+    return request.state;
+}
+
+/**
+ * @brief Releases a semaphore from an interrupt handler.
+ *
+ * The kernel state is updated directly in a critical section; a woken task of
+ * higher priority runs as soon as the interrupt returns. Meant for signal
+ * semaphores (created with a count of 0).
+ *
+ * @param semaphore Pointer to the OS_Semaphore structure to release.
+ * @return OS_SemaphoreState Status of the semaphore release.
+ */
+OS_SemaphoreState OS_ReleaseSemaphoreFromISR(OS_Semaphore* semaphore) {
+    OS_SemaphoreRequest request;
+    uint32_t interrupts;
+
+    request.semaphore = semaphore;
+    request.task = NULL;
+
+    interrupts = OS_EnterCriticalFromISR();
+    if (OS_SemaphoreReleaseService(&request)) {
+        OS_RescheduleFromISR();
+    }
+    OS_ExitCriticalFromISR(interrupts);
+
+    return request.state;
+}
+
+/**
+ * @brief Kernel side of OS_AcquireSemaphore.
+ *
+ * @param request Acquire arguments, the state is written back.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_SemaphoreAcquireService(OS_SemaphoreRequest* request) {
+    OS_Semaphore* semaphore = request->semaphore;
+    OS_TCB* task = request->task;
+
+    semaphore->count--;  // Decrement the semaphore count
+    if (!semaphore->isSignal && task == semaphore->owner) {
+        request->state = OS_SEMAPHORE_ALREADY_ACQUIRED;  // Task already owns the semaphore
+        return 0;
+    }
+    if (semaphore->count < 0 && (semaphore->owner || semaphore->isSignal)) {
+        // If the semaphore is busy and owned, block the task in the waiting queue
+        OS_TRACE(OS_TRACE_SEMAPHORE_CONTENDED, task, OS_TRACE_TASK_ID(semaphore->owner));
+        semaphore->waitingCount++;
+        task->WaitSemaphore = semaphore;
+        OS_WaitQueueBlock(&semaphore->waiters, task, request, OS_WAIT_FOREVER);
+        request->state = OS_SEMAPHORE_BUSY;
+        return 1;
+    }
+
+    if (!semaphore->isSignal)
+        semaphore->owner = task;  // Set the current task as the owner
+    request->state = OS_SEMAPHORE_AVAILABLE;
+    return 0;
+}
+
+/**
+ * @brief Kernel side of OS_ReleaseSemaphore.
+ *
+ * @param request Release arguments, the state is written back.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_SemaphoreReleaseService(OS_SemaphoreRequest* request) {
+    OS_Semaphore* semaphore = request->semaphore;
+    OS_TCB* next;
+
     semaphore->count++;  // Increment the semaphore count
     if (semaphore->count <= 0) {
-        // If there are tasks waiting for the semaphore
-        semaphore->waitingCount--; // Decrement the waiting count
-        OS_FifoDequeue(&(semaphore->waitingQueue), &dequeuedTask); // Dequeue the next waiting task
-        semaphore->owner = dequeuedTask; // Set the dequeued task as the owner
-        OS_ActivateTask(dequeuedTask); // Activate the dequeued task
-        return OS_SEMAPHORE_AVAILABLE; // Indicate the semaphore is available
+        // If there are tasks waiting for the semaphore, the first one becomes the owner
+        next = OS_WaitQueueWake(&semaphore->waiters);
+        if (next != NULL) {
+            semaphore->waitingCount--;
+            next->WaitSemaphore = NULL;
+            if (!semaphore->isSignal)
+                semaphore->owner = next;
+            request->state = OS_SEMAPHORE_AVAILABLE;
+            return 1;
+        }
     }
-    return OS_SEMAPHORE_BUSY; // Indicate the semaphore is still busy
+
+    request->state = OS_SEMAPHORE_BUSY;  // Indicate the semaphore is still busy
+    return 0;
+}
+
+/**
+ * @brief Withdraws a blocked task from the semaphore it waits for (kernel services only).
+ *
+ * Called when the task is terminated or activated again while blocked: the
+ * unit it took from the count when it blocked is given back.
+ *
+ * @param task Pointer to the task, its WaitSemaphore is set.
+ */
+void OS_SemaphoreWaitCancel(OS_TCB* task) {
+    OS_Semaphore* semaphore = task->WaitSemaphore;
+
+    OS_WaitQueueRemove(task);
+    semaphore->count++;
+    semaphore->waitingCount--;
+    task->WaitSemaphore = NULL;
 }
@@ -0,0 +1,275 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Stream buffers between one writer, an interrupt handler, and one reader
+  task. The bytes live in a power-of-two ring indexed by two free running
+  counters: the writer only moves tail and the reader only moves head, so
+  neither side needs a critical section, and a barrier between the bytes and
+  the counter that publishes them is enough. The kernel is only entered to
+  block the reader below its trigger level, and by the writer that wakes it.
+*/
+
+#include <string.h>
+#include "StreamBuffer.h"
+#include "Port.h"
+
+/* Publishes length bytes written at the tail and wakes the reader once it has enough */
+static void OS_StreamPublish(OS_StreamBuffer* stream, uint32_t length) {
+    uint32_t interrupts;
+    OS_TCB* reader;
+
+    // The bytes are visible before the tail that covers them
+    OS_MEMORY_BARRIER();
+    stream->tail += length;
+
+    // Pairs with the barrier of the reader blocking: one of the two sees the other
+    OS_MEMORY_BARRIER();
+    if (stream->wakeLevel == 0)
+        return;
+
+    interrupts = OS_EnterCriticalFromISR();
+    if ((stream->wakeLevel != 0) && (OS_StreamBytesAvailable(stream) >= stream->wakeLevel)) {
+        stream->wakeLevel = 0;
+        reader = OS_WaitQueueWake(&stream->reader);
+        if (reader != NULL) {
+            ((OS_StreamRequest*)reader->WaitRequest)->state = OS_STREAM_OK;
+            OS_RescheduleFromISR();
+        }
+    }
+    OS_ExitCriticalFromISR(interrupts);
+}
+
+/* Copies up to length bytes out of the head of the ring and hands their room back */
+static uint32_t OS_StreamRead(OS_StreamBuffer* stream, uint8_t* data, uint32_t length) {
+    uint32_t head = stream->head;
+    uint32_t stored = stream->tail - head;
+    uint32_t offset = head & (stream->size - 1);
+    uint32_t first;
+
+    // The bytes are read after the tail that published them
+    OS_MEMORY_BARRIER();
+
+    if (length > stored)
+        length = stored;
+
+    // Handle the wrap around the end of the storage
+    first = stream->size - offset;
+    if (first > length)
+        first = length;
+    memcpy(data, stream->base + offset, first);
+    memcpy(data + first, stream->base, length - first);
+
+    // The bytes are read before their room is handed back to the writer
+    OS_MEMORY_BARRIER();
+    stream->head = head + length;
+
+    return length;
+}
+
+/**
+ * @brief Initializes an empty stream buffer.
+ *
+ * @param stream Pointer to the stream buffer to be initialized.
+ * @param buffer Storage for size bytes.
+ * @param size Capacity of the stream buffer in bytes, a power of two.
+ * @param triggerLevel Bytes a blocked reader waits for, 1 to size.
+ * @return OS_StreamState OS_STREAM_INIT_OK, or OS_STREAM_INIT_ERROR for a NULL buffer, a size
+ *         that is not a power of two or a trigger level out of range.
+ */
+OS_StreamState OS_InitStreamBuffer(OS_StreamBuffer* stream, uint8_t* buffer, uint32_t size, uint32_t triggerLevel) {
+    if (!buffer || !size || (size & (size - 1)) || !triggerLevel || (triggerLevel > size))
+        return OS_STREAM_INIT_ERROR;
+
+    stream->base = buffer;
+    stream->size = size;
+    stream->head = 0;
+    stream->tail = 0;
+    stream->triggerLevel = triggerLevel;
+    stream->wakeLevel = 0;
+
+    OS_WaitQueueInit(&stream->reader, OS_WAIT_FIFO);
+
+    return OS_STREAM_INIT_OK;
+}
+
+/**
+ * @brief Changes the trigger level, used from the next receive on.
+ *
+ * @param stream Pointer to the stream buffer.
+ * @param triggerLevel Bytes a blocked reader waits for, 1 to the capacity.
+ * @return OS_StreamState OS_STREAM_OK, or OS_STREAM_INIT_ERROR for a trigger level out of range.
+ */
+OS_StreamState OS_StreamSetTriggerLevel(OS_StreamBuffer* stream, uint32_t triggerLevel) {
+    if (!triggerLevel || (triggerLevel > stream->size))
+        return OS_STREAM_INIT_ERROR;
+
+    stream->triggerLevel = triggerLevel;
+    return OS_STREAM_OK;
+}
+
+/**
+ * @brief Writes bytes from the interrupt handler feeding the stream, without waiting.
+ *
+ * Only the bytes that fit are written. The reader is woken, and runs as soon as
+ * the interrupt returns if it has a higher priority, once its trigger level is reached.
+ *
+ * @param stream Pointer to the stream buffer.
+ * @param data Bytes to write.
+ * @param length Number of bytes to write.
+ * @return uint32_t Number of bytes written.
+ */
+uint32_t OS_StreamSendFromISR(OS_StreamBuffer* stream, const void* data, uint32_t length) {
+    uint32_t tail = stream->tail;
+    uint32_t offset = tail & (stream->size - 1);
+    uint32_t first;
+
+    if (length > OS_StreamSpaceAvailable(stream))
+        length = OS_StreamSpaceAvailable(stream);
+    if (length == 0)
+        return 0;
+
+    // Handle the wrap around the end of the storage
+    first = stream->size - offset;
+    if (first > length)
+        first = length;
+    memcpy(stream->base + offset, data, first);
+    memcpy(stream->base, (const uint8_t*)data + first, length - first);
+
+    OS_StreamPublish(stream, length);
+    return length;
+}
+
+/**
+ * @brief Reserves the free room contiguous with the tail, to be written in place (by a DMA).
+ *
+ * Nothing is published until OS_StreamCommitFromISR; the region stays valid
+ * for the writer until then, the reader only ever frees more room.
+ *
+ * @param stream Pointer to the stream buffer.
+ * @param region Receives the start of the region.
+ * @return uint32_t Size of the region in bytes, 0 if the stream buffer is full.
+ */
+uint32_t OS_StreamReserve(OS_StreamBuffer* stream, uint8_t** region) {
+    uint32_t offset = stream->tail & (stream->size - 1);
+    uint32_t space = OS_StreamSpaceAvailable(stream);
+
+    *region = stream->base + offset;
+
+    // The region ends at the end of the storage, the next one starts at its base
+    if (space > stream->size - offset)
+        space = stream->size - offset;
+    return space;
+}
+
+/**
+ * @brief Publishes bytes written in place in the region given by OS_StreamReserve.
+ *
+ * @param stream Pointer to the stream buffer.
+ * @param length Number of bytes written at the start of the region.
+ * @return uint32_t Number of bytes published, length clipped to the free room.
+ */
+uint32_t OS_StreamCommitFromISR(OS_StreamBuffer* stream, uint32_t length) {
+    if (length > OS_StreamSpaceAvailable(stream))
+        length = OS_StreamSpaceAvailable(stream);
+    if (length == 0)
+        return 0;
+
+    OS_StreamPublish(stream, length);
+    return length;
+}
+
+/**
+ * @brief Reads bytes from the stream, waiting for the trigger level.
+ *
+ * The reader blocks until the trigger level, or length if smaller, is reached,
+ * then takes up to length bytes. Enough bytes already stored, or a zero
+ * timeout, return at once without a kernel call.
+ *
+ * @param stream Pointer to the stream buffer.
+ * @param data Receives the bytes read.
+ * @param length Maximum number of bytes to read.
+ * @param timeout Ticks to wait for the trigger level, 0 to return at once or OS_WAIT_FOREVER.
+ * @return uint32_t Number of bytes read, below the trigger level on a timeout.
+ */
+uint32_t OS_StreamReceive(OS_StreamBuffer* stream, void* data, uint32_t length, uint32_t timeout) {
+    OS_StreamRequest request;
+
+    request.level = (length < stream->triggerLevel) ? length : stream->triggerLevel;
+
+    if ((timeout != 0) && (OS_StreamBytesAvailable(stream) < request.level)) {
+        request.stream = stream;
+        request.task = OS_GetCurrentTask();
+        request.timeout = timeout;
+        request.state = OS_STREAM_TIMEOUT;
+
+        OS_REQUEST_SERVICE_ARG(SVC_STREAM_RECEIVE, &request);
+
+        if (request.state == OS_STREAM_BLOCKED) {
+            // Woken up below the trigger level (timeout): stop waiting
+            OS_REQUEST_SERVICE_ARG(SVC_STREAM_RECEIVE, &request);
+        }
+    }
+
+    return OS_StreamRead(stream, (uint8_t*)data, length);
+}
+
+/**
+ * @brief Returns the number of bytes stored, waiting to be read.
+ */
+uint32_t OS_StreamBytesAvailable(const OS_StreamBuffer* stream) {
+    return stream->tail - stream->head;
+}
+
+/**
+ * @brief Returns the number of bytes that can be written.
+ */
+uint32_t OS_StreamSpaceAvailable(const OS_StreamBuffer* stream) {
+    return stream->size - (stream->tail - stream->head);
+}
+
+/**
+ * @brief Kernel side of OS_StreamReceive.
+ *
+ * @param request Receive arguments, the state is written back.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
+ */
+uint8_t OS_StreamReceiveService(OS_StreamRequest* request) {
+    OS_StreamBuffer* stream = request->stream;
+
+    // Already woken by the writer while the caller was waking up
+    if (request->state == OS_STREAM_OK)
+        return 0;
+
+    // Second call of a blocked reader: the timeout expired
+    if (request->state == OS_STREAM_BLOCKED) {
+        OS_WaitQueueRemove(request->task);
+        stream->wakeLevel = 0;
+        request->state = OS_STREAM_TIMEOUT;
+        return 0;
+    }
+
+    // Announced before the bytes are counted: a writer publishing meanwhile sees the reader
+    stream->wakeLevel = request->level;
+    OS_MEMORY_BARRIER();
+
+    if (OS_StreamBytesAvailable(stream) >= request->level) {
+        stream->wakeLevel = 0;
+        request->state = OS_STREAM_OK;
+        return 0;
+    }
+
+    if (request->timeout == 0) {
+        stream->wakeLevel = 0;
+        request->state = OS_STREAM_EMPTY;
+        return 0;
+    }
+
+    request->state = OS_STREAM_BLOCKED;
+    OS_WaitQueueBlock(&stream->reader, request->task, request, request->timeout);
+    return 1;
+}
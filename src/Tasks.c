@@ -6,8 +6,10 @@
   Contact   : k4.k4.3li@gmail.com
 
   Description:
-  Implements task management and scheduling for the G RTOS, including a bubble sort
-  mechanism for task prioritization, ready queue updates, and idle task processing.
+  Implements task management and scheduling for the G RTOS, including O(1)
+  per-priority ready lists with a priority bitmap (or the legacy bubble sorted
+  task table, or an earliest deadline first heap), ready queue updates, and
+  idle task processing.
 */
 
 #include <Config.h>
@@ -18,14 +20,111 @@
 #include <stddef.h>
 #include "Tasks.h"
 #include "FIFO.h"
+#include "Mutex.h"
+#include "Semaphore.h"
+#include "EventGroup.h"
+#include "Queue.h"
+#include "StreamBuffer.h"
+#include "Timer.h"
+#include "Trace.h"
 
+#if (OS_NUM_CORES > 1) && (OS_SCHEDULER_POLICY != OS_SCHED_PRIORITY_BITMAP)
+#error "OS_NUM_CORES > 1 requires OS_SCHED_PRIORITY_BITMAP: the other schedulers keep a single ready queue"
+#endif
+#if (OS_NUM_CORES > 1) && OS_RUNTIME_STATS_ENABLED
+#error "Runtime statistics are not kept per core: clear OS_RUNTIME_STATS_ENABLED with OS_NUM_CORES > 1"
+#endif
+#if (OS_NUM_CORES > 1) && OS_TICKLESS_IDLE_ENABLED
+#error "Tickless idle stops the tick of a single core: clear OS_TICKLESS_IDLE_ENABLED with OS_NUM_CORES > 1"
+#endif
+
+#if OS_SCHEDULER_POLICY == OS_SCHED_EDF
+/* Ready heap for the EDF scheduler: ReadyHeap[0] has the earliest deadline */
+#define OS_EDF_MAX_READY        100                    // Same bound as the task table
+#define OS_EDF_NOT_READY        0xFF                   // ReadyIndex of a task outside the heap
+OS_TCB* ReadyHeap[OS_EDF_MAX_READY];                   // Binary min-heap of the ready tasks
+uint8_t ReadyHeapSize;                                 // Ready tasks in the heap
+static uint32_t ReadySequence;                         // Next insertion stamp
+static uint32_t DeadlineMisses;                        // Deadline misses of all the tasks
+#elif OS_SCHEDULER_POLICY == OS_SCHED_PRIORITY_BITMAP
+/* Ready lists for the OS scheduler, one set per core */
+#define OS_PRIORITY_LEVELS      (OS_LOWEST_PRIORITY + 1)
+#define OS_READY_BITMAP_WORDS   ((OS_PRIORITY_LEVELS + 31) / 32)
+OS_List ReadyList[OS_NUM_CORES][OS_PRIORITY_LEVELS];         // One FIFO list of ready tasks per priority
+uint32_t ReadyBitmap[OS_NUM_CORES][OS_READY_BITMAP_WORDS];   // Bit set for every non-empty ready list
+uint32_t ReadyGroup[OS_NUM_CORES];                           // Bit set for every non-zero bitmap word
+static OS_TCB* PreemptedTasks[OS_NUM_CORES];   // Ready tasks preempted while holding a raised threshold, latest first
+#if OS_NUM_CORES > 1
+static uint8_t ReadyCount[OS_NUM_CORES];       // Tasks in the ready lists of each core, its idle task included
+#endif
+#else
 /* Ready Queue for the OS scheduler */
 OS_tBuffer ReadyQueue;                 // FIFO buffer for ready tasks
 OS_TCB* ReadyQueueFIFO[100];           // Array to hold tasks in ready queue
-/* Idle Task Structure */
-OS_TCB IdleTask;                       // Control block for the idle task
+#endif
+/* Delay list: delayed tasks sorted by wake-up time, each holding the ticks left after its predecessor */
+OS_List DelayList;
+/* Idle Task Structures */
+OS_TCB IdleTask[OS_NUM_CORES];         // Control block of the idle task of every core
 OS_Control OS_ControlBlock;            // OS Control Block structure to manage system states
+#if OS_PROFILING_ENABLED
+OS_Profile OS_ProfileData;             // Kernel cycle measurements
+#endif
+/* Ticks elapsed since OS_StartOS */
+static uint32_t TickCount;
+#if OS_SCHEDULER_POLICY != OS_SCHED_SORTED_TABLE
+/* The running task used up its time slice or yielded: it goes behind its peers (per core) */
+static uint8_t RoundRobinPending[OS_NUM_CORES];
+#endif
+/* Scheduling decisions that kept the running task, counted over one second of ticks */
+static uint32_t AvoidedSwitches;            // Count of the second in progress
+static uint32_t AvoidedSwitchesPerSecond;   // Count of the last complete second
+static uint32_t AvoidedSwitchesTicks;       // Ticks elapsed in the second in progress
+
+#define OS_TICKS_PER_SECOND     (1000 / OS_TICK_TIME_IN_MS)
+
+/* Scheduling state of the core running the caller */
+#define OS_THIS_CORE            (&OS_ControlBlock.Cores[OS_CORE_ID()])
+
+/* Core whose ready lists hold a task, a constant with a single core */
+#if OS_NUM_CORES > 1
+#define OS_CORE_OF(Task)        ((Task)->Core)
+#else
+#define OS_CORE_OF(Task)        0U
+#endif
+
+#if OS_RUNTIME_STATS_ENABLED
+/* Runtime accounting: the running task is charged the cycles elapsed since RuntimeStamp */
+static uint32_t RuntimeStamp;               // Cycle count of the last charge
+static uint32_t ContextSwitches;            // Context switches performed
+
+/* Arguments of the statistics service, passed by address in R0 */
+typedef struct {
+    OS_TCB* Task;                  // Task of a single task request, NULL for a system snapshot
+    OS_TaskStats* TaskStats;       // Statistics of the task, or of every task for a snapshot
+    OS_SystemStats* SystemStats;   // System statistics of a snapshot
+    uint8_t MaxTasks;              // Room in TaskStats for a snapshot
+} OS_StatsRequest;
+#endif
+
+/* Arguments of the notification services, passed by address in R0 */
+typedef struct {
+    OS_TCB* Task;                  // Notified task, or the waiting task
+    uint32_t Value;                // Value to apply, or the notification value received
+    uint32_t ClearOnExit;          // Bits cleared after a wait consumed the notification
+    uint32_t Timeout;              // Ticks to wait, 0 to poll or OS_WAIT_FOREVER
+    OS_NotifyAction Action;        // Action applied to the notification word
+    OS_NotifyStatus Status;        // Result of the wait service
+} OS_NotifyRequest;
 
+/* Arguments of the periodic delay service, passed by address in R0 */
+typedef struct {
+    OS_TCB* Task;                  // Delayed task
+    uint32_t* PreviousWakeTime;    // Release tick of the current period, moved to the next release
+    uint32_t Period;               // Ticks between two releases
+} OS_DelayUntilRequest;
+
+#if OS_SCHEDULER_POLICY == OS_SCHED_SORTED_TABLE
 /**
  * @brief Bubble sort function to sort tasks based on their priority.
  *
@@ -46,75 +145,1240 @@ void OS_BubbleSort(OS_TCB* TaskTable[], uint8_t NoOfCreatedTasks) {
 }
 
 /**
- * @brief Sorts the scheduler's task table using the bubble sort algorithm.
+ * @brief Sorts the scheduler's task table using the bubble sort algorithm.
+ */
+void OS_SortSchedulerTable() {
+    // Use the bubble sort to sort the task table by priority
+    OS_BubbleSort(OS_ControlBlock.TaskTable, OS_ControlBlock.NoOfCreatedTasks);
+}
+
+/**
+ * @brief Updates the ready queue by enqueuing tasks that are not suspended.
+ */
+void OS_UpdateReadyQueue() {
+    OS_TCB* temp = NULL;
+    OS_TCB* CurrentTask = NULL;
+    OS_TCB* NextTask = NULL;
+
+    // 1- Clear the ready queue
+    while(OS_FifoDequeue(&ReadyQueue, &temp) != FIFO_EMPTY);
+
+    // 2- Update ready queue with tasks that are not suspended
+    for(uint8_t i = 0; i < OS_ControlBlock.NoOfCreatedTasks; i++) {
+        CurrentTask = OS_ControlBlock.TaskTable[i];
+        // The last task of the table has no successor to compare with
+        NextTask = (i + 1 < OS_ControlBlock.NoOfCreatedTasks) ? OS_ControlBlock.TaskTable[i+1] : NULL;
+
+        // Check if the task is not suspended
+        if(CurrentTask->TaskState != OS_TASK_SUSPEND) {
+            // Add task to ready queue based on priority
+            if((NextTask == NULL) || (NextTask->TaskState == OS_TASK_SUSPEND) || (CurrentTask->Priority < NextTask->Priority)) {
+                OS_FifoEnqueue(&ReadyQueue, CurrentTask);
+                CurrentTask->TaskState = OS_TASK_READY;
+                break;
+            }
+            if(CurrentTask->Priority == NextTask->Priority) {
+                OS_FifoEnqueue(&ReadyQueue, CurrentTask);
+                CurrentTask->TaskState = OS_TASK_READY;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Makes a task schedulable by rebuilding the ready queue from the sorted task table.
+ *
+ * @param Task Pointer to the task control block (TCB) that became ready.
+ */
+void OS_ReadyListInsert(OS_TCB* Task) {
+    OS_TRACE(OS_TRACE_READY, Task, 0);
+    Task->TaskState = OS_TASK_WAITING;
+    OS_SortSchedulerTable();
+    OS_UpdateReadyQueue();
+}
+
+/**
+ * @brief Removes a task from scheduling by rebuilding the ready queue from the sorted task table.
+ *
+ * @param Task Pointer to the task control block (TCB) that stopped being ready.
+ */
+void OS_ReadyListRemove(OS_TCB* Task) {
+    OS_TRACE(OS_TRACE_BLOCK, Task, 0);
+    Task->TaskState = OS_TASK_SUSPEND;
+    OS_SortSchedulerTable();
+    OS_UpdateReadyQueue();
+}
+
+/**
+ * @brief Decides which task to run next based on the ready queue.
+ * If no task is ready, the current task continues running, or the idle task is selected.
+ */
+void OS_DecideNext() {
+    // Check if ready queue is empty and if the current task is not suspended
+    if((ReadyQueue.counter == 0) && (OS_ControlBlock.Cores[0].CurrentTask->TaskState != OS_TASK_SUSPEND)) {
+        // Continue running the current task
+        OS_ControlBlock.Cores[0].CurrentTask->TaskState = OS_TASK_RUNNING;
+        OS_FifoEnqueue(&ReadyQueue, OS_ControlBlock.Cores[0].CurrentTask);
+        OS_ControlBlock.Cores[0].NextTask = OS_ControlBlock.Cores[0].CurrentTask;
+    } else {
+        // Get the next task from the ready queue
+        OS_FifoDequeue(&ReadyQueue, &OS_ControlBlock.Cores[0].NextTask);
+
+        // If no next task is available, set idle task as the next task
+        if(!OS_ControlBlock.Cores[0].NextTask) {
+            OS_ControlBlock.Cores[0].NextTask = &IdleTask[0];
+        }
+
+        // Set the next task to running state
+        OS_ControlBlock.Cores[0].NextTask->TaskState = OS_TASK_RUNNING;
+
+        // Maintain round robin scheduling if priority is equal
+        if((OS_ControlBlock.Cores[0].NextTask->Priority == OS_ControlBlock.Cores[0].CurrentTask->Priority) &&
+           (OS_ControlBlock.Cores[0].CurrentTask->TaskState != OS_TASK_SUSPEND)) {
+            OS_FifoEnqueue(&ReadyQueue, OS_ControlBlock.Cores[0].CurrentTask);
+            OS_ControlBlock.Cores[0].CurrentTask->TaskState = OS_TASK_READY;
+        }
+    }
+}
+#elif OS_SCHEDULER_POLICY == OS_SCHED_PRIORITY_BITMAP
+/**
+ * @brief Returns the highest priority owning at least one ready task of a core.
+ *
+ * Priority 0 is mapped to bit 31 of the first bitmap word, so counting the
+ * leading zeros of the group word and then of the selected bitmap word gives
+ * the highest ready priority in two CLZ instructions.
+ *
+ * @param Core Core whose ready lists are looked at.
+ */
+static uint8_t OS_HighestReadyPriority(uint8_t Core) {
+    uint32_t Word = OS_COUNT_LEADING_ZEROS(ReadyGroup[Core]);
+
+    return (uint8_t)((Word << 5) + OS_COUNT_LEADING_ZEROS(ReadyBitmap[Core][Word]));
+}
+
+/**
+ * @brief Returns the priority a ready task has to be above to preempt a running task.
+ *
+ * @param Task Pointer to the running task control block (TCB).
+ */
+static uint8_t OS_PreemptionThreshold(const OS_TCB* Task) {
+    if ((Task->PreemptionThreshold != 0) && (Task->PreemptionThreshold < Task->Priority))
+        return Task->PreemptionThreshold;
+    return Task->Priority;
+}
+
+/**
+ * @brief Appends a task to the ready list of its priority on a given core, in constant time.
+ *
+ * @param Task Pointer to the task control block (TCB) that became ready.
+ * @param Core Core whose ready lists receive the task.
+ */
+static void OS_ReadyListAdd(OS_TCB* Task, uint8_t Core) {
+    uint8_t Priority = Task->Priority;
+
+    OS_TRACE(OS_TRACE_READY, Task, 0);
+    OS_ListInsertTail(&ReadyList[Core][Priority], &Task->ReadyLink);
+    Task->SliceLeft = Task->TimeSlice;
+#if OS_NUM_CORES > 1
+    Task->Core = Core;
+    ReadyCount[Core]++;
+#endif
+
+    // Mark the priority level as ready
+    ReadyBitmap[Core][Priority >> 5] |= (0x80000000UL >> (Priority & 31));
+    ReadyGroup[Core] |= (0x80000000UL >> (Priority >> 5));
+
+    Task->TaskState = OS_TASK_READY;
+}
+
+#if OS_NUM_CORES > 1
+/**
+ * @brief Returns the priority a task made ready has to be above to preempt a core.
+ *
+ * That is the most urgent of the tasks ready on the core and of the threshold of
+ * its running task. A core whose running task stopped being ready takes its
+ * decision again anyway, only its ready tasks count.
+ *
+ * @param Core Core looked at.
+ */
+static uint16_t OS_CorePreemptionLevel(uint8_t Core) {
+    OS_TCB* Running = OS_ControlBlock.Cores[Core].CurrentTask;
+    uint16_t Level = (ReadyGroup[Core] != 0) ? OS_HighestReadyPriority(Core) : OS_PRIORITY_LEVELS;
+
+    if ((Running != NULL) && (Running->TaskState == OS_TASK_RUNNING) &&
+        (OS_PreemptionThreshold(Running) < Level)) {
+        Level = OS_PreemptionThreshold(Running);
+    }
+    return Level;
+}
+
+/**
+ * @brief Selects the core a task made ready is queued on.
+ *
+ * A task still running on its core stays there. Any other task goes to the core
+ * running the lowest priority work among the cores of its affinity, its last
+ * core first on a tie (its data may still be in that core's caches).
+ *
+ * @param Task Pointer to the task control block (TCB) that became ready.
+ * @return uint8_t Selected core.
+ */
+static uint8_t OS_SelectCore(const OS_TCB* Task) {
+    uint8_t Best = Task->Core;
+    uint16_t BestLevel;
+
+    if (OS_ControlBlock.Cores[Best].CurrentTask == Task)
+        return Best;
+
+    if (!(Task->Affinity & (1U << Best))) {
+        Best = (uint8_t)__builtin_ctz(Task->Affinity);
+    }
+    BestLevel = OS_CorePreemptionLevel(Best);
+
+    for (uint8_t Core = 0; Core < OS_NUM_CORES; Core++) {
+        if ((Task->Affinity & (1U << Core)) && (OS_CorePreemptionLevel(Core) > BestLevel)) {
+            Best = Core;
+            BestLevel = OS_CorePreemptionLevel(Core);
+        }
+    }
+
+    return Best;
+}
+#endif
+
+/**
+ * @brief Appends a task to the ready list of its priority in constant time.
+ *
+ * With several cores the task is queued on the core selected by OS_SelectCore,
+ * which is interrupted to take its decision again when the task preempts it.
+ *
+ * @param Task Pointer to the task control block (TCB) that became ready.
+ */
+void OS_ReadyListInsert(OS_TCB* Task) {
+    uint8_t Core = 0;
+
+    // Nothing to do if the task is already in its ready list
+    if (Task->ReadyLink.Container != NULL)
+        return;
+
+#if OS_NUM_CORES > 1
+    Core = OS_SelectCore(Task);
+
+    // The core that made the task ready takes its own decision when its service returns
+    if ((Core != OS_CORE_ID()) && (OS_ControlBlock.OS_Mode == OS_RUNNING) &&
+        (Task->Priority < OS_CorePreemptionLevel(Core))) {
+        OS_SIGNAL_CORE(Core);
+    }
+#endif
+
+    OS_ReadyListAdd(Task, Core);
+}
+
+/**
+ * @brief Removes a task from the ready list of its priority in constant time.
+ *
+ * @param Task Pointer to the task control block (TCB) that stopped being ready.
+ */
+void OS_ReadyListRemove(OS_TCB* Task) {
+    uint8_t Priority = Task->Priority;
+    uint8_t Core = OS_CORE_OF(Task);
+
+    Task->TaskState = OS_TASK_SUSPEND;
+
+    // Nothing to do if the task is not in its ready list
+    if (Task->ReadyLink.Container == NULL)
+        return;
+
+    OS_TRACE(OS_TRACE_BLOCK, Task, 0);
+    OS_ListRemove(&Task->ReadyLink);
+
+#if OS_NUM_CORES > 1
+    ReadyCount[Core]--;
+    // Blocked or suspended by another core while running: its core has to switch it out
+    if ((Core != OS_CORE_ID()) && (OS_ControlBlock.Cores[Core].CurrentTask == Task)) {
+        OS_SIGNAL_CORE(Core);
+    }
+#endif
+
+    // A task leaving the ready lists gives its preemption threshold up
+    if (PreemptedTasks[Core] != NULL) {
+        OS_TCB** Link = &PreemptedTasks[Core];
+
+        while ((*Link != NULL) && (*Link != Task)) {
+            Link = &(*Link)->PreemptedNext;
+        }
+        if (*Link != NULL) {
+            *Link = Task->PreemptedNext;
+        }
+    }
+
+    // Clear the priority level once its list becomes empty
+    if (ReadyList[Core][Priority].Head == NULL) {
+        ReadyBitmap[Core][Priority >> 5] &= ~(0x80000000UL >> (Priority & 31));
+        if (ReadyBitmap[Core][Priority >> 5] == 0) {
+            ReadyGroup[Core] &= ~(0x80000000UL >> (Priority >> 5));
+        }
+    }
+}
+
+/**
+ * @brief Checks whether another task of the same priority is ready to take over.
+ *
+ * @param Task Pointer to the running task control block (TCB).
+ */
+static uint8_t OS_ReadyPeerExists(OS_TCB* Task) {
+    return ((Task->ReadyLink.Container != NULL) && (Task->ReadyLink.Next != &Task->ReadyLink));
+}
+
+#if OS_NUM_CORES > 1
+/**
+ * @brief Returns the first ready priority of a core at or below a given priority.
+ *
+ * @param Core Core whose ready lists are looked at.
+ * @param From Highest priority to consider.
+ * @return uint16_t The ready priority, OS_PRIORITY_LEVELS if there is none.
+ */
+static uint16_t OS_NextReadyPriority(uint8_t Core, uint16_t From) {
+    for (uint16_t Word = From >> 5; Word < OS_READY_BITMAP_WORDS; Word++) {
+        uint32_t Bits = ReadyBitmap[Core][Word];
+
+        if (Word == (From >> 5)) {
+            Bits &= (0xFFFFFFFFUL >> (From & 31));
+        }
+        if (Bits != 0)
+            return (uint16_t)((Word << 5) + OS_COUNT_LEADING_ZEROS(Bits));
+    }
+    return OS_PRIORITY_LEVELS;
+}
+
+/**
+ * @brief Moves to a core the most urgent ready task it may run from the other cores (work stealing).
+ *
+ * Only a task above every task ready on the core is taken, so equal priority
+ * tasks do not bounce between cores, and only from a core whose running task
+ * keeps it waiting: a core taking its decision again, or preempted by the task,
+ * runs it itself.
+ *
+ * @param Core Core looking for work.
+ * @param Limit Priority the stolen task has to be above.
+ */
+static void OS_StealTask(uint8_t Core, uint16_t Limit) {
+    OS_TCB* Stolen = NULL;
+
+    for (uint8_t Other = 0; Other < OS_NUM_CORES; Other++) {
+        OS_TCB* Running;
+        uint16_t Priority;
+
+        // Nothing to take from a core holding only its idle task
+        if ((Other == Core) || (ReadyCount[Other] <= 1))
+            continue;
+
+        Running = OS_ControlBlock.Cores[Other].CurrentTask;
+        if (Running->TaskState != OS_TASK_RUNNING)
+            continue;
+
+        for (Priority = OS_NextReadyPriority(Other, OS_PreemptionThreshold(Running)); Priority < Limit;
+             Priority = OS_NextReadyPriority(Other, Priority + 1)) {
+            OS_ListNode* Head = ReadyList[Other][Priority].Head;
+            OS_ListNode* Node = Head;
+
+            do {
+                OS_TCB* Task = (OS_TCB*)Node->Owner;
+
+                if ((Task->TaskState == OS_TASK_READY) && (Task->Affinity & (1U << Core))) {
+                    Stolen = Task;
+                    Limit = Priority;
+                    break;
+                }
+                Node = Node->Next;
+            } while (Node != Head);
+        }
+    }
+
+    if (Stolen != NULL) {
+        OS_ReadyListRemove(Stolen);
+        OS_ReadyListAdd(Stolen, Core);
+    }
+}
+#endif
+
+/**
+ * @brief Decides which task to run next: the head of the highest priority ready list.
+ * Tasks sharing the highest priority are served in round robin order, one time slice each.
+ *
+ * A task holding a raised preemption threshold keeps the CPU until a task above
+ * its threshold is ready; once preempted, it resumes before any task below its
+ * threshold runs. With several cores the decision is taken for the calling core,
+ * after taking from the other cores a ready task more urgent than its own.
+ */
+void OS_DecideNext() {
+    uint8_t Core = OS_CORE_ID();
+    OS_TCB* CurrentTask = OS_ControlBlock.Cores[Core].CurrentTask;
+    OS_TCB* Preempted;
+    uint8_t Highest;
+    OS_List* List;
+
+#if OS_NUM_CORES > 1
+    {
+        uint16_t Limit = (ReadyGroup[Core] != 0) ? OS_HighestReadyPriority(Core) : OS_PRIORITY_LEVELS;
+
+        if ((CurrentTask->TaskState == OS_TASK_RUNNING) && !RoundRobinPending[Core] &&
+            (OS_PreemptionThreshold(CurrentTask) < Limit)) {
+            Limit = OS_PreemptionThreshold(CurrentTask);
+        }
+        OS_StealTask(Core, Limit);
+    }
+#endif
+
+    // Nothing is ready before the idle task is activated
+    if (ReadyGroup[Core] == 0)
+        return;
+
+    Highest = OS_HighestReadyPriority(Core);
+    Preempted = PreemptedTasks[Core];
+
+    if ((CurrentTask->TaskState == OS_TASK_RUNNING) && !RoundRobinPending[Core]) {
+        // The running task goes on unless a task above its threshold is ready
+        if (Highest >= OS_PreemptionThreshold(CurrentTask)) {
+            OS_ControlBlock.Cores[Core].NextTask = CurrentTask;
+            return;
+        }
+        // Preempted while holding a raised threshold: remember it
+        if (OS_PreemptionThreshold(CurrentTask) != CurrentTask->Priority) {
+            CurrentTask->PreemptedNext = PreemptedTasks[Core];
+            PreemptedTasks[Core] = CurrentTask;
+        }
+    } else if ((Preempted != NULL) && (Highest >= OS_PreemptionThreshold(Preempted))) {
+        // No ready task is above the threshold of the last preempted task: it resumes
+        PreemptedTasks[Core] = Preempted->PreemptedNext;
+        if (CurrentTask->TaskState == OS_TASK_RUNNING) {
+            CurrentTask->TaskState = OS_TASK_READY;
+        }
+        RoundRobinPending[Core] = 0;
+        OS_ControlBlock.Cores[Core].NextTask = Preempted;
+        Preempted->TaskState = OS_TASK_RUNNING;
+        return;
+    }
+
+    // Maintain round robin scheduling: the current task goes behind its peers after its slice
+    if (RoundRobinPending[Core]) {
+        RoundRobinPending[Core] = 0;
+        List = CurrentTask->ReadyLink.Container;
+        if ((List != NULL) && (List->Head == &CurrentTask->ReadyLink)) {
+            OS_ListRotate(List);
+        }
+    }
+
+    List = &ReadyList[Core][Highest];
+
+    // The current task stays ready if it was not removed from its list
+    if (CurrentTask->TaskState == OS_TASK_RUNNING) {
+        CurrentTask->TaskState = OS_TASK_READY;
+    }
+
+    OS_ControlBlock.Cores[Core].NextTask = (OS_TCB*)List->Head->Owner;
+    OS_ControlBlock.Cores[Core].NextTask->TaskState = OS_TASK_RUNNING;
+}
+#else
+/**
+ * @brief Compares the scheduling keys of two tasks, insertion order aside.
+ *
+ * @return int32_t Negative if task A has the earlier key, 0 if the keys are equal.
+ */
+static int32_t OS_EdfCompare(const OS_TCB* A, const OS_TCB* B) {
+    if (A->RelativeDeadline && B->RelativeDeadline)
+        return (int32_t)(A->AbsoluteDeadline - B->AbsoluteDeadline);
+    if (A->RelativeDeadline || B->RelativeDeadline)
+        return (A->RelativeDeadline != 0) ? -1 : 1;
+    return ((int32_t)A->Priority - (int32_t)B->Priority);
+}
+
+/**
+ * @brief Returns 1 if task A has to run before task B.
+ *
+ * Tasks with a deadline come first, the earliest absolute deadline winning
+ * (compared modulo 2^32 so the tick counter may wrap); tasks without one, the
+ * idle task among them, follow by priority. Equal keys are served in
+ * insertion order.
+ */
+static uint8_t OS_EdfBefore(const OS_TCB* A, const OS_TCB* B) {
+    int32_t Difference = OS_EdfCompare(A, B);
+
+    if (Difference != 0)
+        return (Difference < 0);
+    return ((int32_t)(A->ReadySequence - B->ReadySequence) < 0);
+}
+
+/* Stores a task at a heap position */
+static void OS_ReadyHeapPlace(OS_TCB* Task, uint8_t Index) {
+    ReadyHeap[Index] = Task;
+    Task->ReadyIndex = Index;
+}
+
+/* Moves a task up towards the root while it runs before its parent */
+static void OS_ReadyHeapSiftUp(OS_TCB* Task) {
+    uint8_t Index = Task->ReadyIndex;
+
+    while (Index > 0) {
+        uint8_t Parent = (uint8_t)((Index - 1) / 2);
+
+        if (!OS_EdfBefore(Task, ReadyHeap[Parent]))
+            break;
+        OS_ReadyHeapPlace(ReadyHeap[Parent], Index);
+        Index = Parent;
+    }
+    OS_ReadyHeapPlace(Task, Index);
+}
+
+/* Moves a task down while one of its children runs before it */
+static void OS_ReadyHeapSiftDown(OS_TCB* Task) {
+    uint8_t Index = Task->ReadyIndex;
+
+    while (1) {
+        uint16_t Child = (uint16_t)(2 * Index + 1);
+
+        if (Child >= ReadyHeapSize)
+            break;
+        if (((Child + 1) < ReadyHeapSize) && OS_EdfBefore(ReadyHeap[Child + 1], ReadyHeap[Child]))
+            Child++;
+        if (!OS_EdfBefore(ReadyHeap[Child], Task))
+            break;
+        OS_ReadyHeapPlace(ReadyHeap[Child], Index);
+        Index = (uint8_t)Child;
+    }
+    OS_ReadyHeapPlace(Task, Index);
+}
+
+/**
+ * @brief Counts a deadline miss of the current job of a task, once per job.
+ *
+ * @param Task Pointer to the task control block (TCB).
+ */
+static void OS_DeadlineCheck(OS_TCB* Task) {
+    if ((Task->RelativeDeadline == 0) || Task->DeadlineMissed)
+        return;
+
+    if ((int32_t)(TickCount - Task->AbsoluteDeadline) > 0) {
+        Task->DeadlineMissed = 1;
+        Task->DeadlineMisses++;
+        DeadlineMisses++;
+    }
+}
+
+/**
+ * @brief Inserts a ready task in the heap in O(log n).
+ *
+ * @param Task Pointer to the task control block (TCB) that became ready.
+ */
+void OS_ReadyListInsert(OS_TCB* Task) {
+    // Nothing to do if the task is already in the heap
+    if (Task->ReadyIndex != OS_EDF_NOT_READY)
+        return;
+
+    OS_TRACE(OS_TRACE_READY, Task, 0);
+    Task->ReadySequence = ReadySequence++;
+    Task->SliceLeft = Task->TimeSlice;
+    Task->ReadyIndex = ReadyHeapSize++;
+    OS_ReadyHeapSiftUp(Task);
+
+    Task->TaskState = OS_TASK_READY;
+}
+
+/**
+ * @brief Removes a task from the heap in O(log n), the last task fills the hole.
+ *
+ * @param Task Pointer to the task control block (TCB) that stopped being ready.
+ */
+void OS_ReadyListRemove(OS_TCB* Task) {
+    uint8_t Index = Task->ReadyIndex;
+    OS_TCB* Last;
+
+    Task->TaskState = OS_TASK_SUSPEND;
+
+    // Nothing to do if the task is not in the heap
+    if (Index == OS_EDF_NOT_READY)
+        return;
+
+    OS_TRACE(OS_TRACE_BLOCK, Task, 0);
+    OS_DeadlineCheck(Task);
+    Task->ReadyIndex = OS_EDF_NOT_READY;
+
+    Last = ReadyHeap[--ReadyHeapSize];
+    if (Last == Task)
+        return;
+
+    Last->ReadyIndex = Index;
+    if ((Index > 0) && OS_EdfBefore(Last, ReadyHeap[(Index - 1) / 2])) {
+        OS_ReadyHeapSiftUp(Last);
+    } else {
+        OS_ReadyHeapSiftDown(Last);
+    }
+}
+
+/**
+ * @brief Checks whether another task with the same key as the root is ready to take over.
+ *
+ * A task with the root key has only such tasks above it, so one of the root
+ * children has that key too.
+ *
+ * @param Task Pointer to the running task control block (TCB).
+ */
+static uint8_t OS_ReadyPeerExists(OS_TCB* Task) {
+    if ((ReadyHeapSize == 0) || (ReadyHeap[0] != Task))
+        return (Task->ReadyIndex != OS_EDF_NOT_READY);
+
+    return (((ReadyHeapSize > 1) && (OS_EdfCompare(ReadyHeap[1], Task) == 0)) ||
+            ((ReadyHeapSize > 2) && (OS_EdfCompare(ReadyHeap[2], Task) == 0)));
+}
+
+/**
+ * @brief Decides which task to run next: the root of the ready heap.
+ * Tasks sharing the root key are served in round robin order, one time slice each.
+ */
+void OS_DecideNext() {
+    OS_TCB* CurrentTask = OS_ControlBlock.Cores[0].CurrentTask;
+
+    // Nothing is ready before the idle task is activated
+    if (ReadyHeapSize == 0)
+        return;
+
+    // Maintain round robin scheduling: after its slice, a fresh stamp moves the current task behind its equals
+    if (RoundRobinPending[0]) {
+        RoundRobinPending[0] = 0;
+        if (CurrentTask->ReadyIndex != OS_EDF_NOT_READY) {
+            CurrentTask->ReadySequence = ReadySequence++;
+            OS_ReadyHeapSiftDown(CurrentTask);
+        }
+    }
+
+    // The current task stays ready if it was not removed from the heap
+    if (CurrentTask->TaskState == OS_TASK_RUNNING) {
+        CurrentTask->TaskState = OS_TASK_READY;
+    }
+
+    OS_ControlBlock.Cores[0].NextTask = ReadyHeap[0];
+    OS_ControlBlock.Cores[0].NextTask->TaskState = OS_TASK_RUNNING;
+}
+
+/**
+ * @brief Returns the number of deadline misses of all the tasks.
+ */
+uint32_t OS_GetDeadlineMisses(void) {
+    return DeadlineMisses;
+}
+#endif
+
+/**
+ * @brief Starts a new job of a task: its deadline is counted from now (OS_SCHED_EDF only).
+ *
+ * Called when the task is activated or woken up by its delay, a timeout or an
+ * event; a task handed a mutex continues its job and keeps its deadline.
+ *
+ * @param Task Pointer to the task control block (TCB).
+ */
+static void OS_ReleaseJob(OS_TCB* Task) {
+#if OS_SCHEDULER_POLICY == OS_SCHED_EDF
+    // The previous job was checked when the task left the heap
+    Task->AbsoluteDeadline = TickCount + Task->RelativeDeadline;
+    Task->DeadlineMissed = 0;
+#else
+    (void)Task;
+#endif
+}
+
+/**
+ * @brief Returns the number of ticks elapsed since OS_StartOS.
+ */
+uint32_t OS_GetTickCount(void) {
+    return TickCount;
+}
+
+/**
+ * @brief Returns the control block of the calling task.
+ */
+OS_TCB* OS_GetCurrentTask(void) {
+#if OS_NUM_CORES > 1
+    // Masked, the caller cannot move to another core between the two reads
+    uint32_t Interrupts = OS_EnterCriticalFromISR();
+    OS_TCB* Task = OS_THIS_CORE->CurrentTask;
+
+    OS_ExitCriticalFromISR(Interrupts);
+    return Task;
+#else
+    return OS_ControlBlock.Cores[0].CurrentTask;
+#endif
+}
+
+/**
+ * @brief Returns the core running the caller, 0 with a single core.
+ *
+ * A task may be moved to another core as soon as the call returns, unless its
+ * Affinity allows a single core.
+ */
+uint8_t OS_GetCoreId(void) {
+    return OS_CORE_ID();
+}
+
+/**
+ * @brief Checks whether the last scheduling decision needs a context switch.
+ *
+ * When OS_DecideNext selected the running task again, NextTask is cleared so a
+ * PendSV that is already pending returns at once, and the avoided switch is counted.
+ *
+ * @return uint8_t 1 if PendSV has to be triggered, 0 if the running task keeps the CPU.
+ */
+uint8_t OS_SwitchRequired() {
+    OS_Core* Core = OS_THIS_CORE;
+
+    if (Core->NextTask != Core->CurrentTask)
+        return 1;
+
+    Core->NextTask = NULL;
+    AvoidedSwitches++;
+    return 0;
+}
+
+/**
+ * @brief Returns how many context switches were avoided during the last second.
+ */
+uint32_t OS_GetAvoidedSwitchesPerSecond() {
+    return AvoidedSwitchesPerSecond;
+}
+
+/**
+ * @brief Changes the effective priority of a task (priority inheritance).
+ *
+ * A ready task moves to the ready list of its new priority, a task blocked on a
+ * synchronization object is moved to its new place in the wait list.
+ *
+ * @param Task Pointer to the task control block (TCB).
+ * @param Priority New effective priority.
+ */
+void OS_ChangeTaskPriority(OS_TCB* Task, uint8_t Priority) {
+    OS_WaitQueue* Queue = Task->WaitQueue;
+
+    if (Task->Priority == Priority)
+        return;
+
+    if (Task->TaskState != OS_TASK_SUSPEND) {
+#if OS_SCHEDULER_POLICY == OS_SCHED_EDF
+        // Same job: the deadline is kept, only the position in the heap changes
+        Task->Priority = Priority;
+        if (Task->ReadyIndex != OS_EDF_NOT_READY) {
+            OS_ReadyHeapSiftUp(Task);
+            OS_ReadyHeapSiftDown(Task);
+        }
+#else
+        OS_ReadyListRemove(Task);
+        Task->Priority = Priority;
+        OS_ReadyListInsert(Task);
+#endif
+    } else if ((Queue != NULL) && (Queue->Order == OS_WAIT_PRIORITY)) {
+        OS_ListRemove(&Task->WaitLink);
+        Task->Priority = Priority;
+        Task->WaitLink.Value = Priority;
+        OS_ListInsertOrdered(&Queue->Tasks, &Task->WaitLink);
+    } else {
+        Task->Priority = Priority;
+        Task->WaitLink.Value = Priority;
+    }
+}
+
+/**
+ * @brief Inserts a task in the delay list.
+ *
+ * The list holds tick deltas: each node stores the ticks left after its predecessor
+ * expires, so the tick handler only has to look at the head.
+ *
+ * @param Task Pointer to the task control block (TCB) to be delayed.
+ * @param NoOfTicks Number of ticks to wait, must be at least 1.
+ */
+static void OS_DelayListInsert(OS_TCB* Task, uint32_t NoOfTicks) {
+    OS_ListInsertDelta(&DelayList, &Task->DelayLink, NoOfTicks);
+}
+
+/**
+ * @brief Removes a task from the delay list before its delay expired.
+ *
+ * @param Task Pointer to the task control block (TCB) to be removed.
+ */
+static void OS_DelayListRemove(OS_TCB* Task) {
+    if (Task->DelayLink.Container == NULL)
+        return;
+
+    // The successor inherits the remaining delta
+    OS_ListRemoveDelta(&Task->DelayLink);
+    Task->Waiting.Blocking = OS_TASK_BLOCKING_DISABLE;
+}
+
+/**
+ * @brief Delays a task until its next periodic release (kernel services only).
+ *
+ * The release times stay on the grid PreviousWakeTime + k * Period, whatever
+ * time the task spent running. A task that is already past its next release
+ * does not block: it is released at the last grid point that has elapsed and
+ * every release point it went past is counted as an overrun.
+ *
+ * @param Request Periodic delay arguments, PreviousWakeTime is written back.
+ */
+static void OS_DelayUntilTake(OS_DelayUntilRequest* Request) {
+    OS_TCB* Task = Request->Task;
+    uint32_t Elapsed = TickCount - *Request->PreviousWakeTime;
+
+    OS_ReadyListRemove(Task);
+    // Signed: a PreviousWakeTime set in the future (phase) is a release still to come
+    if ((int32_t)(Elapsed - Request->Period) < 0) {
+        *Request->PreviousWakeTime += Request->Period;
+        Task->Waiting.Blocking = OS_TASK_BLOCKING_ENABLE;
+        OS_DelayListInsert(Task, Request->Period - Elapsed);
+    } else {
+        // Overrun: skip the releases already gone, keep the phase
+        Task->Overruns += (Elapsed - 1) / Request->Period;
+        *Request->PreviousWakeTime += (Elapsed / Request->Period) * Request->Period;
+        OS_ReleaseJob(Task);
+        OS_ReadyListInsert(Task);
+    }
+}
+
+/**
+ * @brief Initializes an empty wait queue.
+ *
+ * @param Queue Pointer to the wait queue.
+ * @param Order Order in which the blocked tasks are served.
+ */
+void OS_WaitQueueInit(OS_WaitQueue* Queue, OS_WaitOrder Order) {
+    OS_ListInit(&Queue->Tasks);
+    Queue->Order = Order;
+}
+
+/**
+ * @brief Blocks a task in a wait queue (kernel services only).
+ *
+ * @param Queue Pointer to the wait queue.
+ * @param Task Pointer to the task control block (TCB) to block.
+ * @param Request Arguments of the blocking service, completed by the task that wakes it.
+ * @param Timeout Ticks before the task is woken up anyway, or OS_WAIT_FOREVER.
+ */
+void OS_WaitQueueBlock(OS_WaitQueue* Queue, OS_TCB* Task, void* Request, uint32_t Timeout) {
+    Task->WaitQueue = Queue;
+    Task->WaitRequest = Request;
+    Task->WaitLink.Value = Task->Priority;
+
+    if (Queue->Order == OS_WAIT_PRIORITY) {
+        OS_ListInsertOrdered(&Queue->Tasks, &Task->WaitLink);
+    } else {
+        OS_ListInsertTail(&Queue->Tasks, &Task->WaitLink);
+    }
+
+    OS_ReadyListRemove(Task);
+    if (Timeout != OS_WAIT_FOREVER) {
+        Task->Waiting.Blocking = OS_TASK_BLOCKING_ENABLE;
+        OS_DelayListInsert(Task, Timeout);
+    }
+}
+
+/**
+ * @brief Wakes the first task of a wait queue (kernel services only).
+ *
+ * @param Queue Pointer to the wait queue.
+ * @return OS_TCB* The woken task, NULL if the queue is empty.
+ */
+OS_TCB* OS_WaitQueueWake(OS_WaitQueue* Queue) {
+    OS_TCB* Task;
+
+    if (Queue->Tasks.Head == NULL)
+        return NULL;
+
+    Task = (OS_TCB*)Queue->Tasks.Head->Owner;
+    OS_WaitQueueWakeTask(Task);
+
+    return Task;
+}
+
+/**
+ * @brief Wakes a given task of the wait queue it is blocked in (kernel services only).
+ *
+ * @param Task Pointer to the task control block (TCB), anywhere in its wait queue.
+ */
+void OS_WaitQueueWakeTask(OS_TCB* Task) {
+    OS_WaitQueueRemove(Task);
+    OS_DelayListRemove(Task);
+    if (Task->WaitMutex == NULL) {
+        OS_ReleaseJob(Task);
+    }
+    OS_ReadyListInsert(Task);
+}
+
+/**
+ * @brief Unlinks a task from the wait queue it is blocked in, if any (kernel services only).
+ *
+ * @param Task Pointer to the task control block (TCB).
+ */
+void OS_WaitQueueRemove(OS_TCB* Task) {
+    OS_ListRemove(&Task->WaitLink);
+    Task->WaitQueue = NULL;
+}
+
+/**
+ * @brief Withdraws a task from the synchronization object it is blocked on, if any.
+ *
+ * Called when the task is activated again or terminated: no waker may complete
+ * its request, a frame on the stack of a task that will not read it any more.
+ *
+ * @param Task Pointer to the task control block (TCB).
+ */
+static void OS_WaitCancel(OS_TCB* Task) {
+    if (Task->WaitMutex != NULL) {
+        OS_MutexWaitCancel(Task);
+    } else if (Task->WaitSemaphore != NULL) {
+        OS_SemaphoreWaitCancel(Task);
+    } else {
+        OS_WaitQueueRemove(Task);
+    }
+    if (Task->NotifyState == OS_TASK_NOTIFY_WAITING) {
+        // A notification arriving later stays pending instead of completing the lost wait
+        Task->NotifyState = OS_TASK_NOTIFY_NONE;
+    }
+    Task->WaitRequest = NULL;
+}
+
+/**
+ * @brief Selects the next task and requests a context switch after a service call.
+ */
+static void OS_Reschedule(void) {
+    if(OS_ControlBlock.OS_Mode == OS_RUNNING) {
+        // The idle task is activated before the first context switch is possible
+        if(OS_THIS_CORE->CurrentTask != &IdleTask[OS_CORE_ID()]) {
+            OS_DecideNext();
+            if (OS_SwitchRequired()) {
+                OS_TRIGGER_PENDSV();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Selects the next task after an interrupt changed the kernel state (FromISR services).
+ *
+ * Only PendSV is pended: running at the lowest priority, it switches once every
+ * nested interrupt has returned, however many FromISR calls were made.
+ */
+void OS_RescheduleFromISR(void) {
+    if (OS_ControlBlock.OS_Mode == OS_RUNNING) {
+        OS_DecideNext();
+        if (OS_SwitchRequired()) {
+            OS_TRIGGER_PENDSV();
+        }
+    }
+}
+
+/* Critical sections
+ * They mask the kernel interrupt band (BASEPRI on Cortex-M3): the interrupts that
+ * may call the FromISR services, SysTick and PendSV. The interrupts above
+ * OS_KERNEL_INTERRUPT_PRIORITY are never masked by the kernel.
+ */
+static uint32_t CriticalNesting[OS_NUM_CORES];   // Nesting depth of the task level critical sections of each core
+#if OS_PROFILING_ENABLED
+static uint32_t MaskedStartCycles;     // Cycle count when the band was masked
+#endif
+
+/* Records the duration of a critical section that unmasked the band */
+#if OS_PROFILING_ENABLED
+static void OS_ProfileMasked(void) {
+    OS_ProfileData.MaskedLastCycles = OS_GET_CYCLE_COUNT() - MaskedStartCycles;
+    if (OS_ProfileData.MaskedLastCycles > OS_ProfileData.MaskedMaxCycles) {
+        OS_ProfileData.MaskedMaxCycles = OS_ProfileData.MaskedLastCycles;
+    }
+}
+#endif
+
+/* Task level entry, privileged: only the outermost entry masks the band */
+static void OS_CriticalEnter(void) {
+    if (CriticalNesting[OS_CORE_ID()]++ == 0) {
+        (void)OS_MASK_INTERRUPTS();
+#if OS_PROFILING_ENABLED
+        MaskedStartCycles = OS_GET_CYCLE_COUNT();
+#endif
+    }
+}
+
+/* Task level exit, privileged: only the outermost exit unmasks the band */
+static void OS_CriticalExit(void) {
+    uint8_t Core = OS_CORE_ID();
+
+    if (CriticalNesting[Core] == 0)
+        return;
+
+    if (--CriticalNesting[Core] == 0) {
+#if OS_PROFILING_ENABLED
+        OS_ProfileMasked();
+#endif
+        OS_RESTORE_INTERRUPTS(0);
+    }
+}
+
+/**
+ * @brief Enters a critical section from a task, may be nested.
+ *
+ * Keep it short and do not call blocking services inside: the context switch
+ * and the tick are masked until the outermost OS_ExitCritical.
+ */
+void OS_EnterCritical(void) {
+#if OS_TASKS_CAN_MASK_INTERRUPTS
+    OS_CriticalEnter();
+#else
+    OS_REQUEST_SERVICE(SVC_ENTER_CRITICAL);  // BASEPRI is only writable by privileged code
+#endif
+}
+
+/**
+ * @brief Leaves a critical section entered with OS_EnterCritical.
+ */
+void OS_ExitCritical(void) {
+#if OS_TASKS_CAN_MASK_INTERRUPTS
+    OS_CriticalExit();
+#else
+    OS_REQUEST_SERVICE(SVC_EXIT_CRITICAL);
+#endif
+}
+
+/**
+ * @brief Enters a critical section from an interrupt handler (or the kernel exception handlers).
+ *
+ * An interrupt waking the CPU during a stretched tickless period accounts for
+ * the ticks slept here, before it reads or changes the kernel state.
+ *
+ * @return uint32_t Previous mask state, to hand to OS_ExitCriticalFromISR.
+ */
+uint32_t OS_EnterCriticalFromISR(void) {
+    uint32_t State = OS_MASK_INTERRUPTS();
+
+#if OS_TICKLESS_IDLE_ENABLED
+    OS_TicklessExit();
+#endif
+
+#if OS_PROFILING_ENABLED
+    if (State == 0) {
+        MaskedStartCycles = OS_GET_CYCLE_COUNT();
+    }
+#endif
+    return State;
+}
+
+/**
+ * @brief Leaves a critical section entered with OS_EnterCriticalFromISR.
+ *
+ * @param State Value returned by the matching OS_EnterCriticalFromISR.
+ */
+void OS_ExitCriticalFromISR(uint32_t State) {
+#if OS_PROFILING_ENABLED
+    if (State == 0) {
+        OS_ProfileMasked();
+    }
+#endif
+    OS_RESTORE_INTERRUPTS(State);
+}
+
+#if OS_RUNTIME_STATS_ENABLED
+/* Charges the cycles elapsed since the last charge to a task */
+static void OS_RuntimeCharge(OS_TCB* Task) {
+    uint32_t Now = OS_GET_CYCLE_COUNT();
+
+    Task->Runtime.RunTime += (uint32_t)(Now - RuntimeStamp);
+    RuntimeStamp = Now;
+}
+
+/* Accounts for a context switch in the runtime statistics */
+static void OS_RuntimeSwitch(OS_TCB* Previous, OS_TCB* Next) {
+    OS_RuntimeCharge(Previous);
+
+    // Still ready: a higher priority task or its time slice took the CPU
+    if (Previous->TaskState == OS_TASK_READY) {
+        Previous->Runtime.Preemptions++;
+    }
+    Next->Runtime.SwitchesIn++;
+    ContextSwitches++;
+}
+
+/* Share of a run time in the total time, in 0.01 % */
+static uint16_t OS_RuntimeUsage(uint64_t RunTime, uint64_t TotalTime) {
+    if (TotalTime < 10000)
+        return 0;
+    return (uint16_t)(RunTime / (TotalTime / 10000));
+}
+
+/* Copies the accounting of a task */
+static void OS_RuntimeCopy(OS_TCB* Task, OS_TaskStats* Stats, uint64_t TotalTime) {
+    Stats->Task = Task;
+    Stats->RunTime = Task->Runtime.RunTime;
+    Stats->SwitchesIn = Task->Runtime.SwitchesIn;
+    Stats->Preemptions = Task->Runtime.Preemptions;
+    Stats->CpuUsage = OS_RuntimeUsage(Task->Runtime.RunTime, TotalTime);
+}
+
+/* Kernel side of the statistics calls: one consistent copy taken in handler mode */
+static void OS_RuntimeSnapshot(OS_StatsRequest* Request) {
+    uint64_t TotalTime = 0;
+    uint8_t NoOfTasks = 0;
+
+    OS_RuntimeCharge(OS_ControlBlock.Cores[0].CurrentTask);
+
+    for (uint8_t i = 0; i < OS_ControlBlock.NoOfCreatedTasks; i++) {
+        TotalTime += OS_ControlBlock.TaskTable[i]->Runtime.RunTime;
+    }
+
+    if (Request->Task != NULL) {
+        OS_RuntimeCopy(Request->Task, Request->TaskStats, TotalTime);
+        return;
+    }
+
+    if (Request->TaskStats != NULL) {
+        while ((NoOfTasks < Request->MaxTasks) && (NoOfTasks < OS_ControlBlock.NoOfCreatedTasks)) {
+            OS_RuntimeCopy(OS_ControlBlock.TaskTable[NoOfTasks], &Request->TaskStats[NoOfTasks], TotalTime);
+            NoOfTasks++;
+        }
+    }
+
+    Request->SystemStats->TotalTime = TotalTime;
+    Request->SystemStats->IdleTime = IdleTask[0].Runtime.RunTime;
+    Request->SystemStats->ContextSwitches = ContextSwitches;
+    Request->SystemStats->IdleUsage = OS_RuntimeUsage(IdleTask[0].Runtime.RunTime, TotalTime);
+    Request->SystemStats->NoOfTasks = NoOfTasks;
+}
+
+/**
+ * @brief Reads the CPU usage statistics of a task.
+ *
+ * @param Task Pointer to the task control block (TCB).
+ * @param Stats Receives the statistics, CpuUsage is relative to the time since OS_StartOS.
+ * @return OS_ErrorStatus OS_OK, or OS_INVALID_PARAMETER for a NULL argument.
+ */
+OS_ErrorStatus OS_GetTaskStats(OS_TCB* Task, OS_TaskStats* Stats) {
+    OS_StatsRequest Request;
+
+    if ((Task == NULL) || (Stats == NULL))
+        return OS_INVALID_PARAMETER;
+
+    Request.Task = Task;
+    Request.TaskStats = Stats;
+    Request.SystemStats = NULL;
+    Request.MaxTasks = 1;
+
+    OS_REQUEST_SERVICE_ARG(SVC_RUNTIME_STATS, &Request);  // The cycle counter is privileged
+    return OS_OK;
+}
+
+/**
+ * @brief Takes a consistent snapshot of the system and, optionally, of every task.
+ *
+ * @param Stats Receives the system statistics.
+ * @param TaskStats Receives the statistics of the tasks in creation order, may be NULL.
+ * @param MaxTasks Number of entries of TaskStats.
+ * @return OS_ErrorStatus OS_OK, or OS_INVALID_PARAMETER for a NULL Stats.
+ */
+OS_ErrorStatus OS_GetSystemStats(OS_SystemStats* Stats, OS_TaskStats* TaskStats, uint8_t MaxTasks) {
+    OS_StatsRequest Request;
+
+    if (Stats == NULL)
+        return OS_INVALID_PARAMETER;
+
+    Request.Task = NULL;
+    Request.TaskStats = TaskStats;
+    Request.SystemStats = Stats;
+    Request.MaxTasks = MaxTasks;
+
+    OS_REQUEST_SERVICE_ARG(SVC_RUNTIME_STATS, &Request);
+    return OS_OK;
+}
+#endif
+
+#if OS_SWITCH_HOOK_ENABLED
+/**
+ * @brief Accounts for a context switch, called by PendSV before the switch.
+ *
+ * @param Previous Task switched out.
+ * @param Next Task switched in.
  */
-void OS_SortSchedulerTable() {
-    // Use the bubble sort to sort the task table by priority
-    OS_BubbleSort(OS_ControlBlock.TaskTable, OS_ControlBlock.NoOfCreatedTasks);
+void OS_TaskSwitched(OS_TCB* Previous, OS_TCB* Next) {
+#if OS_RUNTIME_STATS_ENABLED
+    OS_RuntimeSwitch(Previous, Next);
+#endif
+    OS_TRACE(OS_TRACE_SWITCH, Next, OS_TRACE_TASK_ID(Previous));
 }
+#endif
 
 /**
- * @brief Updates the ready queue by enqueuing tasks that are not suspended.
+ * @brief Consumes a pending notification, or blocks the caller until one arrives.
+ *
+ * A wait that blocked is completed by OS_NotifyGive when the notification arrives,
+ * or by a second call from the woken task after a timeout.
+ *
+ * @param Request Wait arguments, Status and Value are written back.
  */
-void OS_UpdateReadyQueue() {
-    OS_TCB* temp = NULL;
-    OS_TCB* CurrentTask = NULL;
-    OS_TCB* NextTask = NULL;
-
-    // 1- Clear the ready queue
-    while(OS_FifoDequeue(&ReadyQueue, &temp) != FIFO_EMPTY);
+static void OS_NotifyTake(OS_NotifyRequest* Request) {
+    OS_TCB* Task = Request->Task;
 
-    // 2- Update ready queue with tasks that are not suspended
-    for(uint8_t i = 0; i < OS_ControlBlock.NoOfCreatedTasks; i++) {
-        CurrentTask = OS_ControlBlock.TaskTable[i];
-        NextTask = OS_ControlBlock.TaskTable[i+1];
+    // Already completed by the notifier while the caller was waking up
+    if (Request->Status == OS_NOTIFY_OK)
+        return;
 
-        // Check if the task is not suspended
-        if(CurrentTask->TaskState != OS_TASK_SUSPEND) {
-            // Add task to ready queue based on priority
-            if((NextTask->TaskState == OS_TASK_SUSPEND) || (CurrentTask->Priority < NextTask->Priority)) {
-                OS_FifoEnqueue(&ReadyQueue, CurrentTask);
-                CurrentTask->TaskState = OS_TASK_READY;
-                break;
-            }
-            if(CurrentTask->Priority == NextTask->Priority) {
-                OS_FifoEnqueue(&ReadyQueue, CurrentTask);
-                CurrentTask->TaskState = OS_TASK_READY;
-            }
+    if (Task->NotifyState == OS_TASK_NOTIFY_PENDING) {
+        Request->Value = Task->NotifyValue;
+        Request->Status = OS_NOTIFY_OK;
+        Task->NotifyValue &= ~Request->ClearOnExit;
+        Task->NotifyState = OS_TASK_NOTIFY_NONE;
+    } else if ((Request->Timeout == 0) || (Request->Status == OS_NOTIFY_BLOCKED)) {
+        // Nothing received: polling, or the blocked wait timed out
+        Request->Value = Task->NotifyValue;
+        Request->Status = OS_NOTIFY_TIMEOUT;
+        Task->NotifyState = OS_TASK_NOTIFY_NONE;
+    } else {
+        Request->Status = OS_NOTIFY_BLOCKED;
+        Task->NotifyState = OS_TASK_NOTIFY_WAITING;
+        Task->WaitRequest = Request;
+        OS_ReadyListRemove(Task);
+        if (Request->Timeout != OS_WAIT_FOREVER) {
+            Task->Waiting.Blocking = OS_TASK_BLOCKING_ENABLE;
+            OS_DelayListInsert(Task, Request->Timeout);
         }
+        OS_Reschedule();
     }
 }
 
 /**
- * @brief Decides which task to run next based on the ready queue.
- * If no task is ready, the current task continues running, or the idle task is selected.
+ * @brief Applies a notification to its target and wakes it if it waits for one.
+ *
+ * @param Request Notification arguments: target task, value and action.
+ * @return uint8_t 1 if the scheduling decision has to be taken again.
  */
-void OS_DecideNext() {
-    // Check if ready queue is empty and if the current task is not suspended
-    if((ReadyQueue.counter == 0) && (OS_ControlBlock.CurrentTask->TaskState != OS_TASK_SUSPEND)) {
-        // Continue running the current task
-        OS_ControlBlock.CurrentTask->TaskState = OS_TASK_RUNNING;
-        OS_FifoEnqueue(&ReadyQueue, OS_ControlBlock.CurrentTask);
-        OS_ControlBlock.NextTask = OS_ControlBlock.CurrentTask;
-    } else {
-        // Get the next task from the ready queue
-        OS_FifoDequeue(&ReadyQueue, &OS_ControlBlock.NextTask);
+static uint8_t OS_NotifyGive(OS_NotifyRequest* Request) {
+    OS_TCB* Task = Request->Task;
 
-        // If no next task is available, set idle task as the next task
-        if(!OS_ControlBlock.NextTask) {
-            OS_ControlBlock.NextTask = &IdleTask;
-        }
+    switch (Request->Action) {
+        case OS_NOTIFY_SET_BITS:
+            Task->NotifyValue |= Request->Value;
+        break;
 
-        // Set the next task to running state
-        OS_ControlBlock.NextTask->TaskState = OS_TASK_RUNNING;
+        case OS_NOTIFY_INCREMENT:
+            Task->NotifyValue++;
+        break;
 
-        // Maintain round robin scheduling if priority is equal
-        if((OS_ControlBlock.NextTask->Priority == OS_ControlBlock.CurrentTask->Priority) &&
-           (OS_ControlBlock.CurrentTask->TaskState != OS_TASK_SUSPEND)) {
-            OS_FifoEnqueue(&ReadyQueue, OS_ControlBlock.CurrentTask);
-            OS_ControlBlock.CurrentTask->TaskState = OS_TASK_READY;
-        }
+        case OS_NOTIFY_OVERWRITE:
+            Task->NotifyValue = Request->Value;
+        break;
+    }
+
+    if ((Task->NotifyState == OS_TASK_NOTIFY_WAITING) && (Task->WaitRequest != NULL)) {
+        // Complete the wait of the target and wake it in constant time, no queue involved
+        Task->NotifyState = OS_TASK_NOTIFY_PENDING;
+        OS_NotifyTake((OS_NotifyRequest*)Task->WaitRequest);
+        OS_DelayListRemove(Task);
+        OS_ReleaseJob(Task);
+        OS_ReadyListInsert(Task);
+        return 1;
     }
+
+    Task->NotifyState = OS_TASK_NOTIFY_PENDING;
+    return 0;
 }
 
 /**
@@ -122,50 +1386,321 @@ void OS_DecideNext() {
  * @param Stack_Pointer Pointer to the task's stack, which holds the SVC number and parameters.
  */
 void OS_SvcServices(uint32_t* Stack_Pointer) {
+#if OS_PROFILING_ENABLED
+    uint32_t StartCycles = OS_GET_CYCLE_COUNT();
+#endif
     // Extract the SVC number from the stack
-    uint8_t SVC_ID = *((uint8_t*)(((uint8_t*)Stack_Pointer[6]) - 2));
+    uint8_t SVC_ID = OS_SVC_GET_ID(Stack_Pointer);
+    // The target task is passed in R0
+    OS_TCB* Task = (OS_TCB*)OS_SVC_GET_ARG(Stack_Pointer);
+
+    OS_TRACE(OS_TRACE_SVC, OS_THIS_CORE->CurrentTask, SVC_ID);
+
+#if OS_TICKLESS_IDLE_ENABLED
+    // Account for the ticks slept by the idle task before touching the kernel state
+    OS_TicklessExit();
+#endif
 
     switch(SVC_ID) {
         case SVC_ACTIVATE:
+            OS_DelayListRemove(Task);
+            OS_WaitCancel(Task);
+            if (Task->TaskState == OS_TASK_SUSPEND) {
+                OS_ReleaseJob(Task);
+            }
+            OS_ReadyListInsert(Task);
+            OS_Reschedule();
+        break;
+
         case SVC_TERMINATE:
-            // Sort the scheduler table and update the ready queue
-            OS_SortSchedulerTable();
-            OS_UpdateReadyQueue();
+            OS_DelayListRemove(Task);
+            OS_WaitCancel(Task);
+            OS_ReadyListRemove(Task);
+            OS_Reschedule();
+        break;
 
-            if(OS_ControlBlock.OS_Mode == OS_RUNNING) {
-                if(strcmp(OS_ControlBlock.CurrentTask->TaskName, "IDLE") != 0) {
-                    OS_DecideNext();
-                    OS_TRIGGER_PENDSV();
-                }
+        case SVC_DELAY:
+            OS_ReadyListRemove(Task);
+            if (Task->Waiting.TicksCount == 0) {
+                // Zero ticks: go to the back of the ready list
+                OS_ReadyListInsert(Task);
+            } else {
+                Task->Waiting.Blocking = OS_TASK_BLOCKING_ENABLE;
+                OS_DelayListInsert(Task, Task->Waiting.TicksCount);
+            }
+            OS_Reschedule();
+        break;
+
+        case SVC_DELAY_UNTIL:
+            OS_DelayUntilTake((OS_DelayUntilRequest*)Task);
+            OS_Reschedule();
+        break;
+
+        case SVC_YIELD:
+#if OS_SCHEDULER_POLICY != OS_SCHED_SORTED_TABLE
+            // The rest of the slice is given up, the next turn starts a full one
+            OS_THIS_CORE->CurrentTask->SliceLeft = OS_THIS_CORE->CurrentTask->TimeSlice;
+            RoundRobinPending[OS_CORE_ID()] = 1;
+#endif
+            OS_Reschedule();
+        break;
+
+        case SVC_TIMER:
+#if OS_TIMERS_ENABLED
+            if (OS_TimerService((OS_TimerRequest*)Task)) {
+                OS_Reschedule();
             }
+#endif
         break;
 
         case SVC_WAITING:
+#if OS_SCHEDULER_POLICY == OS_SCHED_SORTED_TABLE
             OS_SortSchedulerTable();
             OS_UpdateReadyQueue();
+#endif
         break;
 
         case SVC_SUSPEND:
         break;
+
+        case SVC_ACQUIRE_MUTEX:
+            if (OS_MutexAcquireService((OS_MutexRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_RELEASE_MUTEX:
+            if (OS_MutexReleaseService((OS_MutexRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_ACQUIRE_SEMAPHORE:
+            if (OS_SemaphoreAcquireService((OS_SemaphoreRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_RELEASE_SEMAPHORE:
+            if (OS_SemaphoreReleaseService((OS_SemaphoreRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_EVENT_WAIT:
+            if (OS_EventGroupWaitService((OS_EventGroupRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_EVENT_SET:
+            if (OS_EventGroupSetService((OS_EventGroupRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_QUEUE_SEND:
+            if (OS_QueueSendService((OS_QueueRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_QUEUE_RECEIVE:
+            if (OS_QueueReceiveService((OS_QueueRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_STREAM_RECEIVE:
+            if (OS_StreamReceiveService((OS_StreamRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_NOTIFY:
+            if (OS_NotifyGive((OS_NotifyRequest*)Task)) {
+                OS_Reschedule();
+            }
+        break;
+
+        case SVC_NOTIFY_WAIT:
+            OS_NotifyTake((OS_NotifyRequest*)Task);
+        break;
+
+        case SVC_ENTER_CRITICAL:
+            OS_CriticalEnter();
+        break;
+
+        case SVC_EXIT_CRITICAL:
+            OS_CriticalExit();
+        break;
+
+        case SVC_RUNTIME_STATS:
+#if OS_RUNTIME_STATS_ENABLED
+            OS_RuntimeSnapshot((OS_StatsRequest*)Task);
+#endif
+        break;
+
+        case SVC_TICKLESS_IDLE:
+#if OS_TICKLESS_IDLE_ENABLED
+            if (OS_GetExpectedIdleTicks() >= OS_TICKLESS_MIN_IDLE_TICKS) {
+                OS_TicklessEnter(OS_GetExpectedIdleTicks());
+            }
+#endif
+        break;
     }
+
+#if OS_PROFILING_ENABLED
+    OS_ProfileData.SvcLastCycles = OS_GET_CYCLE_COUNT() - StartCycles;
+    if (OS_ProfileData.SvcLastCycles > OS_ProfileData.SvcMaxCycles) {
+        OS_ProfileData.SvcMaxCycles = OS_ProfileData.SvcLastCycles;
+    }
+#endif
 }
 
 /**
- * @brief Updates the number of ticks for each task.
- * Decrements the tick count for blocking tasks and requests a wait service if the count reaches zero.
+ * @brief Updates the delay list on every tick.
+ * Only the head of the delta list is decremented; every task whose delay expired is made ready.
  */
 void OS_UpdateNoOfTicks() {
-    for(uint8_t i = 0; i < OS_ControlBlock.NoOfCreatedTasks; i++) {
-        if(OS_ControlBlock.TaskTable[i]->Waiting.Blocking == OS_TASK_BLOCKING_ENABLE) {
-            OS_ControlBlock.TaskTable[i]->Waiting.TicksCount--;
-            if(OS_ControlBlock.TaskTable[i]->Waiting.TicksCount == 1) {
-                OS_ControlBlock.TaskTable[i]->TaskState = OS_TASK_WAITING;
-                OS_ControlBlock.TaskTable[i]->Waiting.Blocking = OS_TASK_BLOCKING_DISABLE;
-                OS_REQUEST_SERVICE(SVC_WAITING);  // Request SVC for task state update
-            }
+    OS_ListNode* Head = DelayList.Head;
+
+    TickCount++;
+#if OS_SCHEDULER_POLICY == OS_SCHED_EDF
+    // The root has the earliest deadline: if it is not late, no ready task is
+    if (ReadyHeapSize > 0) {
+        OS_DeadlineCheck(ReadyHeap[0]);
+    }
+#endif
+
+#if OS_RUNTIME_STATS_ENABLED
+    // Keep the elapsed cycles below the counter wrap while a task runs for long
+    OS_RuntimeCharge(OS_ControlBlock.Cores[0].CurrentTask);
+#endif
+    OS_TRACE(OS_TRACE_TICK, OS_THIS_CORE->CurrentTask, 0);
+
+    // Publish the avoided switches once per second
+    if (++AvoidedSwitchesTicks >= OS_TICKS_PER_SECOND) {
+        AvoidedSwitchesPerSecond = AvoidedSwitches;
+        AvoidedSwitches = 0;
+        AvoidedSwitchesTicks = 0;
+    }
+
+#if OS_SCHEDULER_POLICY != OS_SCHED_SORTED_TABLE
+#if OS_NUM_CORES > 1
+    uint8_t WorkWaiting = 0;
+
+    // A task waits for a core when one holds more than its idle task and the task it runs
+    for (uint8_t Core = 0; Core < OS_NUM_CORES; Core++) {
+        WorkWaiting |= (ReadyCount[Core] > 2);
+    }
+#endif
+
+    // Charge the tick to the time slice of the task running on every core
+    for (uint8_t Core = 0; Core < OS_NUM_CORES; Core++) {
+        OS_TCB* Running = OS_ControlBlock.Cores[Core].CurrentTask;
+
+        if (--Running->SliceLeft == 0) {
+            Running->SliceLeft = Running->TimeSlice;
+#if OS_SCHEDULER_POLICY == OS_SCHED_PRIORITY_BITMAP
+            // A raised preemption threshold also keeps the equal priority tasks waiting
+            RoundRobinPending[Core] = (OS_PreemptionThreshold(Running) == Running->Priority);
+#else
+            RoundRobinPending[Core] = 1;
+#endif
+        }
+#if OS_NUM_CORES > 1
+        // The tick interrupts one core: the others rotate, or look for work while idle, on request
+        if ((Core != OS_CORE_ID()) &&
+            ((RoundRobinPending[Core] && OS_ReadyPeerExists(Running)) || (WorkWaiting && (Running == &IdleTask[Core])))) {
+            OS_SIGNAL_CORE(Core);
         }
+#endif
+    }
+#endif
+
+#if OS_TIMERS_ENABLED
+    OS_TimerTick();
+#endif
+
+    if (Head == NULL)
+        return;
+
+    Head->Value--;
+
+    // Wake the head and every task sharing its wake-up tick
+    while ((Head != NULL) && (Head->Value == 0)) {
+        OS_TCB* Task = (OS_TCB*)Head->Owner;
+
+        OS_ListRemove(Head);
+        Task->Waiting.Blocking = OS_TASK_BLOCKING_DISABLE;
+        OS_ReleaseJob(Task);
+        OS_ReadyListInsert(Task);  // Already in handler mode, no SVC needed
+
+        Head = DelayList.Head;
+    }
+}
+/**
+ * @brief Returns how many ticks the idle task can sleep without missing a wake-up.
+ *
+ * @return uint32_t 0 if another task is ready, the ticks until the first delayed
+ *         task wakes up, or 0xFFFFFFFF if no task is delayed.
+ */
+uint32_t OS_GetExpectedIdleTicks() {
+    // Ticks are still needed while any other task is ready
+#if OS_SCHEDULER_POLICY == OS_SCHED_PRIORITY_BITMAP
+    OS_ListNode* IdleHead = ReadyList[0][OS_LOWEST_PRIORITY].Head;
+
+    if ((OS_HighestReadyPriority(0) != OS_LOWEST_PRIORITY) || (IdleHead->Next != IdleHead))
+        return 0;
+#elif OS_SCHEDULER_POLICY == OS_SCHED_EDF
+    if ((ReadyHeapSize != 1) || (ReadyHeap[0] != &IdleTask[0]))
+        return 0;
+#else
+    for(uint8_t i = 0; i < OS_ControlBlock.NoOfCreatedTasks; i++) {
+        if((OS_ControlBlock.TaskTable[i] != &IdleTask[0]) &&
+           (OS_ControlBlock.TaskTable[i]->TaskState != OS_TASK_SUSPEND))
+            return 0;
+    }
+#endif
+
+#if OS_TIMERS_ENABLED
+    // The first timer expiry wakes the timer daemon task
+    if ((DelayList.Head == NULL) || (OS_TimerGetExpectedIdleTicks() < DelayList.Head->Value))
+        return OS_TimerGetExpectedIdleTicks();
+#else
+    if (DelayList.Head == NULL)
+        return 0xFFFFFFFF;       // Only an interrupt can make a task ready
+#endif
+
+    return DelayList.Head->Value;
+}
+
+/**
+ * @brief Accounts for ticks that elapsed while the periodic tick was suppressed.
+ *
+ * @param NoOfTicks Number of elapsed ticks, the tick that ends the idle period
+ *        is still processed by OS_UpdateNoOfTicks.
+ */
+void OS_StepTickCount(uint32_t NoOfTicks) {
+    OS_ListNode* Head = DelayList.Head;
+
+    AvoidedSwitchesTicks += NoOfTicks;
+    TickCount += NoOfTicks;
+#if OS_TIMERS_ENABLED
+    OS_TimerStepTickCount(NoOfTicks);
+#endif
+
+    if (Head == NULL)
+        return;
+
+    // The idle period never goes past the first wake-up, keep it for the next tick
+    if (NoOfTicks >= Head->Value) {
+        NoOfTicks = Head->Value - 1;
     }
+    Head->Value -= NoOfTicks;
 }
+
 /**
  * @brief Registers a callback function to be called during the SysTick task's execution.
  * @param callback The function pointer for the SysTick hook callback.
@@ -195,7 +1730,10 @@ void OS_IdleTask() {
         }
 #endif
         IdleTaskTest ^= 1;  // For testing using logic analyzer
-        __asm("WFE");       // Wait for event to enter sleep mode (power efficiency)
+#if OS_TICKLESS_IDLE_ENABLED
+        OS_REQUEST_SERVICE(SVC_TICKLESS_IDLE);  // Stretch the tick up to the next wake-up (privileged)
+#endif
+        OS_WAIT_FOR_EVENT();  // Wait for event to enter sleep mode (power efficiency)
     }
 }
 /**
@@ -215,6 +1753,15 @@ OS_ErrorStatus OS_CreateTask(OS_TCB* Task) {
         return OS_PRIORITY_OUT_OF_RANGE;  // Return an error if priority is out of range
     }
 
+    // Cores the task may run on: every core unless the task names some, and at least one of them
+    if (Task->Affinity == 0) {
+        Task->Affinity = OS_ALL_CORES;
+    } else if ((Task->Affinity & OS_ALL_CORES) == 0) {
+        return OS_INVALID_PARAMETER;
+    }
+    Task->Affinity &= OS_ALL_CORES;
+    Task->Core = (uint8_t)__builtin_ctz(Task->Affinity);
+
     // Allocate stack memory and ensure it's not exceeding the PSP stack region
     Task->_S_PSP_Task = OS_ControlBlock.PSP_LastEnd;
     Task->_E_PSP_Task = Task->_S_PSP_Task - Task->StackSize;
@@ -225,6 +1772,49 @@ OS_ErrorStatus OS_CreateTask(OS_TCB* Task) {
     // Create the stack for the task
     OS_CreateStack(Task);
 
+    // Bind the ready, delay and wait list links to the task
+    OS_ListNodeInit(&Task->ReadyLink, Task);
+    OS_ListNodeInit(&Task->DelayLink, Task);
+    OS_ListNodeInit(&Task->WaitLink, Task);
+    Task->WaitQueue = NULL;
+    Task->WaitRequest = NULL;
+    Task->WaitMutex = NULL;
+    Task->WaitSemaphore = NULL;
+    OS_ListInit(&Task->HeldMutexes);
+    Task->BasePriority = Task->Priority;
+    Task->Waiting.Blocking = OS_TASK_BLOCKING_DISABLE;
+    Task->Overruns = 0;
+
+    // Round robin time slice, the configured default unless the task sets its own
+    if (Task->TimeSlice == 0) {
+        Task->TimeSlice = OS_TIME_SLICE_TICKS;
+    }
+    Task->SliceLeft = Task->TimeSlice;
+    Task->PreemptedNext = NULL;
+
+    // No notification received yet
+    Task->NotifyValue = 0;
+    Task->NotifyState = OS_TASK_NOTIFY_NONE;
+
+#if OS_SCHEDULER_POLICY == OS_SCHED_EDF
+    // Not ready, no job released yet
+    Task->ReadyIndex = OS_EDF_NOT_READY;
+    Task->AbsoluteDeadline = 0;
+    Task->DeadlineMisses = 0;
+    Task->DeadlineMissed = 0;
+#endif
+
+#if OS_RUNTIME_STATS_ENABLED
+    // Nothing accounted yet
+    Task->Runtime.RunTime = 0;
+    Task->Runtime.SwitchesIn = 0;
+    Task->Runtime.Preemptions = 0;
+#endif
+
+#if OS_TRACE_ENABLED
+    OS_TraceTaskCreated(Task);
+#endif
+
     // Add task to Scheduler table (Waiting Queue)
     OS_ControlBlock.TaskTable[OS_ControlBlock.NoOfCreatedTasks++] = Task;
 
@@ -241,11 +1831,8 @@ OS_ErrorStatus OS_CreateTask(OS_TCB* Task) {
  * @return OS_ErrorStatus Returns the status of the activation process (OS_OK if successful).
  */
 OS_ErrorStatus OS_ActivateTask(OS_TCB* Task) {
-    // Change task state from Suspended to Waiting
-    Task->TaskState = OS_TASK_WAITING;
-
-    // Request task activation via Supervisor Call (SVC)
-    OS_REQUEST_SERVICE(SVC_ACTIVATE);
+    // Request task activation via Supervisor Call (SVC), the kernel moves it to the ready list
+    OS_REQUEST_SERVICE_ARG(SVC_ACTIVATE, Task);
 
     return OS_OK;
 }
@@ -257,11 +1844,8 @@ OS_ErrorStatus OS_ActivateTask(OS_TCB* Task) {
  * @return OS_ErrorStatus Returns the status of the termination process (OS_OK if successful).
  */
 OS_ErrorStatus OS_TerminateTask(OS_TCB* Task) {
-    // Change task state from Waiting to Suspended
-    Task->TaskState = OS_TASK_SUSPEND;
-
-    // Request task termination via Supervisor Call (SVC)
-    OS_REQUEST_SERVICE(SVC_TERMINATE);
+    // Request task termination via Supervisor Call (SVC), the kernel removes it from the ready list
+    OS_REQUEST_SERVICE_ARG(SVC_TERMINATE, Task);
 
     return OS_OK;
 }
@@ -270,20 +1854,144 @@ OS_ErrorStatus OS_TerminateTask(OS_TCB* Task) {
  * @brief Puts a task in a delay state for a specified number of ticks.
  *
  * @param Task Pointer to the task control block (TCB) to be delayed.
- * @param Copy_u32NoOfTicks Number of ticks to delay the task.
+ * @param Copy_u32NoOfTicks Number of ticks to delay the task (0 only yields to tasks of the same priority).
  * @return OS_ErrorStatus Returns the status of the delay process (OS_OK if successful).
  */
 OS_ErrorStatus OS_DelayTask(OS_TCB* Task, uint32_t Copy_u32NoOfTicks) {
-    // Enable task blocking and set the tick count for the delay
-    Task->Waiting.Blocking = OS_TASK_BLOCKING_ENABLE;
+    // Set the tick count for the delay
     Task->Waiting.TicksCount = Copy_u32NoOfTicks;
 
-    // Terminate the task until the delay period is over
-    OS_TerminateTask(Task);
+    // Request the kernel to move the task to the delay list until the delay period is over
+    OS_REQUEST_SERVICE_ARG(SVC_DELAY, Task);
+
+    return OS_OK;
+}
+
+/**
+ * @brief Hands the CPU over to the next ready task of the same priority.
+ *
+ * The calling task goes behind its peers with a full time slice for its next
+ * turn. Without a ready peer the call returns at once, no kernel call is made.
+ */
+void OS_Yield(void) {
+#if OS_SCHEDULER_POLICY != OS_SCHED_SORTED_TABLE
+    if (!OS_ReadyPeerExists(OS_GetCurrentTask()))
+        return;
+#endif
+
+    OS_REQUEST_SERVICE(SVC_YIELD);
+}
+
+/**
+ * @brief Delays the calling task until its next periodic release.
+ *
+ * Unlike OS_DelayTask, the wake-up time is absolute: a loop calling it with the
+ * same period is released every Period ticks without accumulating its own
+ * execution time. Initialize *PreviousWakeTime with OS_GetTickCount() before
+ * the first call, adding a phase to shift the releases. Releases the task ran past are counted in
+ * Task->Overruns.
+ *
+ * @param Task Pointer to the task control block (TCB) of the calling task.
+ * @param PreviousWakeTime Release tick of the current period, updated to the next release.
+ * @param Period Ticks between two releases, at least 1.
+ * @return OS_ErrorStatus OS_OK, or OS_INVALID_PARAMETER for a zero period.
+ */
+OS_ErrorStatus OS_DelayUntil(OS_TCB* Task, uint32_t* PreviousWakeTime, uint32_t Period) {
+    OS_DelayUntilRequest Request;
+
+    if ((Period == 0) || (PreviousWakeTime == NULL))
+        return OS_INVALID_PARAMETER;
+
+    Request.Task = Task;
+    Request.PreviousWakeTime = PreviousWakeTime;
+    Request.Period = Period;
+
+    // The kernel compares the release with its own tick count, so no tick can be lost in between
+    OS_REQUEST_SERVICE_ARG(SVC_DELAY_UNTIL, &Request);
+
+    return OS_OK;
+}
+
+/**
+ * @brief Sends a direct-to-task notification.
+ *
+ * @param Task Pointer to the task control block (TCB) of the notified task.
+ * @param Value Value applied to the notification word.
+ * @param Action How the value is applied (set bits, increment or overwrite).
+ * @return OS_ErrorStatus Returns the status of the notification (OS_OK if successful).
+ */
+OS_ErrorStatus OS_Notify(OS_TCB* Task, uint32_t Value, OS_NotifyAction Action) {
+    OS_NotifyRequest Request;
+
+    Request.Task = Task;
+    Request.Value = Value;
+    Request.Action = Action;
+
+    // The kernel updates the word and wakes the task if it waits for it
+    OS_REQUEST_SERVICE_ARG(SVC_NOTIFY, &Request);
+
+    return OS_OK;
+}
+
+/**
+ * @brief Sends a direct-to-task notification from an interrupt handler.
+ *
+ * The kernel state is updated directly in a critical section; a woken task of
+ * higher priority runs as soon as the interrupt returns.
+ *
+ * @param Task Pointer to the task control block (TCB) of the notified task.
+ * @param Value Value applied to the notification word.
+ * @param Action How the value is applied (set bits, increment or overwrite).
+ * @return OS_ErrorStatus Returns the status of the notification (OS_OK if successful).
+ */
+OS_ErrorStatus OS_NotifyFromISR(OS_TCB* Task, uint32_t Value, OS_NotifyAction Action) {
+    OS_NotifyRequest Request;
+    uint32_t Interrupts;
+
+    Request.Task = Task;
+    Request.Value = Value;
+    Request.Action = Action;
+
+    Interrupts = OS_EnterCriticalFromISR();
+    if (OS_NotifyGive(&Request)) {
+        OS_RescheduleFromISR();
+    }
+    OS_ExitCriticalFromISR(Interrupts);
 
     return OS_OK;
 }
 
+/**
+ * @brief Waits for a notification to the calling task.
+ *
+ * @param ClearOnExit Bits of the notification word cleared once it has been received.
+ * @param NotificationValue Receives the notification word before clearing (may be NULL).
+ * @param Timeout Ticks to wait, 0 to only check, or OS_WAIT_FOREVER.
+ * @return OS_NotifyStatus OS_NOTIFY_OK if a notification was received, OS_NOTIFY_TIMEOUT otherwise.
+ */
+OS_NotifyStatus OS_NotifyWait(uint32_t ClearOnExit, uint32_t* NotificationValue, uint32_t Timeout) {
+    OS_NotifyRequest Request;
+
+    Request.Task = OS_GetCurrentTask();
+    Request.ClearOnExit = ClearOnExit;
+    Request.Timeout = Timeout;
+    Request.Status = OS_NOTIFY_TIMEOUT;
+
+    // Consume a pending notification or block until one arrives
+    OS_REQUEST_SERVICE_ARG(SVC_NOTIFY_WAIT, &Request);
+
+    if (Request.Status == OS_NOTIFY_BLOCKED) {
+        // Woken up without a notification (timeout): stop waiting
+        OS_REQUEST_SERVICE_ARG(SVC_NOTIFY_WAIT, &Request);
+    }
+
+    if (NotificationValue != NULL) {
+        *NotificationValue = Request.Value;
+    }
+
+    return Request.Status;
+}
+
 /**
  * @brief Initializes the operating system.
  *
@@ -298,20 +2006,52 @@ OS_ErrorStatus OS_Init() {
     // Set OS mode to Suspended
     OS_ControlBlock.OS_Mode = OS_SUSPEND;
 
+#if OS_TRACE_ENABLED
+    // Empty trace, before the idle task is created and named
+    OS_TraceInit();
+#endif
+
     // Assign the main stack for the OS
     Error += OS_CreateMainStack();
 
+    // No task is delayed yet
+    OS_ListInit(&DelayList);
+
+#if OS_SCHEDULER_POLICY == OS_SCHED_PRIORITY_BITMAP
+    // Create the per-priority ready lists of every core, no priority is ready yet
+    for (uint8_t Core = 0; Core < OS_NUM_CORES; Core++) {
+        for (uint16_t i = 0; i < OS_PRIORITY_LEVELS; i++) {
+            OS_ListInit(&ReadyList[Core][i]);
+        }
+        for (uint8_t i = 0; i < OS_READY_BITMAP_WORDS; i++) {
+            ReadyBitmap[Core][i] = 0;
+        }
+        ReadyGroup[Core] = 0;
+    }
+#elif OS_SCHEDULER_POLICY == OS_SCHED_EDF
+    // No task is ready yet
+    ReadyHeapSize = 0;
+#else
     // Create the ready queue to store tasks ready for execution
     if (OS_FifoInit(&ReadyQueue, ReadyQueueFIFO, 100) != FIFO_NO_ERROR) {
         Error += FIFO_INIT_ERROR;
     }
+#endif
+
+    // Initialize the Idle task of every core
+    for (uint8_t Core = 0; Core < OS_NUM_CORES; Core++) {
+        strcpy(IdleTask[Core].TaskName, "IDLE");
+        IdleTask[Core].Priority = OS_LOWEST_PRIORITY;    // Lowest priority for idle task
+        IdleTask[Core].Affinity = (uint8_t)(1U << Core); // Never leaves its core
+        IdleTask[Core].func = OS_IdleTask;               // Idle task function
+        IdleTask[Core].StackSize = 300;                  // Set stack size for idle task
+        Error += OS_CreateTask(&IdleTask[Core]);         // Create the idle task
+    }
 
-    // Initialize the Idle task
-    strcpy(IdleTask.TaskName, "IDLE");
-    IdleTask.Priority = OS_LOWEST_PRIORITY;    // Lowest priority for idle task
-    IdleTask.func = OS_IdleTask;               // Idle task function
-    IdleTask.StackSize = 300;                  // Set stack size for idle task
-    Error += OS_CreateTask(&IdleTask);         // Create the idle task
+#if OS_TIMERS_ENABLED
+    // Create the timer daemon task
+    Error += OS_TimerInit();
+#endif
 
     return Error;  // Return any errors encountered during initialization
 }
@@ -325,24 +2065,42 @@ OS_ErrorStatus OS_StartOS() {
     // 1- Set the OS mode to Running
     OS_ControlBlock.OS_Mode = OS_RUNNING;
 
-    // 2- By default, start the Idle task as the first task
-    OS_ControlBlock.CurrentTask = &IdleTask;
+    // 2- By default, start the Idle task as the first task of every core
+    for (uint8_t Core = 0; Core < OS_NUM_CORES; Core++) {
+        OS_ControlBlock.Cores[Core].CurrentTask = &IdleTask[Core];
+    }
 
-    // 3- Activate the Idle task (won't be immediately activated based on its conditions)
-    OS_ActivateTask(&IdleTask);
+    // 3- Activate the Idle tasks (won't be immediately activated based on their conditions)
+    for (uint8_t Core = 0; Core < OS_NUM_CORES; Core++) {
+        OS_ActivateTask(&IdleTask[Core]);
+    }
 
     // 4- Start the system timer
     OS_StartTimer();
+#if OS_RUNTIME_STATS_ENABLED
+    RuntimeStamp = OS_GET_CYCLE_COUNT();
+    IdleTask[0].Runtime.SwitchesIn = 1;
+#endif
+
+#if OS_NUM_CORES > 1
+    // The other cores run their idle task, then every core takes its first decision
+    OS_StartCores();
+    for (uint8_t Core = 0; Core < OS_NUM_CORES; Core++) {
+        OS_SIGNAL_CORE(Core);
+    }
+#endif
 
     // 5- Set PSP (Process Stack Pointer) to the Idle task's stack
-    OS_SET_PSP(OS_ControlBlock.CurrentTask->CurrentPSP);
+    OS_SET_PSP(OS_ControlBlock.Cores[0].CurrentTask->CurrentPSP);
 
     // Switch to Process Stack Pointer mode and non-privileged mode
     OS_SWITCH_TO_PSP();
+#if !OS_PRIVILEGED_TASKS
     OS_SWITCH_TO_NOT_PRIVELEGE();
+#endif
 
     // Execute the Idle task function (system enters its main loop)
-    OS_ControlBlock.CurrentTask->func();
+    OS_ControlBlock.Cores[0].CurrentTask->func();
 
     return OS_OK;  // OS successfully started
 }
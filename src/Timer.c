@@ -0,0 +1,333 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Software timer service. Active timers wait in a delta list like the delayed
+  tasks, so a tick only looks at the head of the list. Expired timers are
+  moved to a FIFO list and the timer daemon task, woken once, runs their
+  callbacks one after the other. Auto-reload timers are re-armed relatively to
+  their expiry tick, so their period does not drift with the callback latency.
+*/
+
+#include <Config.h>
+#include <string.h>
+#include "Timer.h"
+#include "Port.h"
+
+#if OS_TIMERS_ENABLED
+
+static OS_List ActiveTimers;       // Armed timers, sorted by expiry (Value holds the delta ticks)
+static OS_List ExpiredTimers;      // Expired timers waiting for their callback, in expiry order
+static OS_WaitQueue DaemonQueue;   // The daemon task while no timer has expired
+static OS_TCB TimerTask;           // Control block of the timer daemon task
+
+/* Arms a timer for its period from now */
+static void OS_TimerArm(OS_Timer* timer) {
+    OS_ListRemoveDelta(&timer->link);
+    OS_ListInsertDelta(&ActiveTimers, &timer->link, timer->period);
+}
+
+/* Disarms a timer and drops its pending callback */
+static void OS_TimerDisarm(OS_Timer* timer) {
+    OS_ListRemoveDelta(&timer->link);
+    OS_ListRemove(&timer->expiredLink);
+}
+
+/**
+ * @brief Body of the timer daemon task: runs the callbacks of the expired timers.
+ *
+ * The daemon blocks while no timer has expired; the tick wakes it when the first
+ * one does, and it then takes them one by one, in expiry order.
+ */
+static void OS_TimerDaemon(void) {
+    OS_TimerRequest request;
+
+    request.task = &TimerTask;
+    request.command = OS_TIMER_CMD_TAKE;
+
+    while (1) {
+        request.timer = NULL;
+        OS_REQUEST_SERVICE_ARG(SVC_TIMER, &request);
+
+        // A request that blocked returns without a timer: the next one takes it
+        if (request.timer != NULL) {
+            request.timer->callback(request.timer);
+        }
+    }
+}
+
+/**
+ * @brief Initializes the timer service and creates the timer daemon task (called by OS_Init).
+ *
+ * @return OS_ErrorStatus Returns the status of the daemon task creation (OS_OK if successful).
+ */
+OS_ErrorStatus OS_TimerInit(void) {
+    OS_ErrorStatus error;
+
+    OS_ListInit(&ActiveTimers);
+    OS_ListInit(&ExpiredTimers);
+    OS_WaitQueueInit(&DaemonQueue, OS_WAIT_FIFO);
+
+    strcpy(TimerTask.TaskName, "TIMER");
+    TimerTask.Priority = OS_TIMER_TASK_PRIORITY;
+    TimerTask.func = OS_TimerDaemon;
+    TimerTask.StackSize = OS_TIMER_TASK_STACK_SIZE;
+    error = OS_CreateTask(&TimerTask);
+    if (error != OS_OK)
+        return error;
+
+    // The daemon blocks at its first request until a timer expires
+    return OS_ActivateTask(&TimerTask);
+}
+
+/**
+ * @brief Initializes an inactive software timer.
+ *
+ * @param timer Pointer to the timer to be initialized.
+ * @param callback Function called by the timer daemon task at each expiry.
+ * @param argument Application data stored in the timer for the callback.
+ * @param period Ticks from start to expiry, and between two expiries of an auto-reload timer.
+ * @param mode OS_TIMER_ONE_SHOT or OS_TIMER_AUTO_RELOAD.
+ * @return OS_TimerState OS_TIMER_OK, or OS_TIMER_ERROR for a NULL callback or a zero period.
+ */
+OS_TimerState OS_TimerCreate(OS_Timer* timer, OS_TimerCallback callback, void* argument, uint32_t period, OS_TimerMode mode) {
+    if (!timer || !callback || !period)
+        return OS_TIMER_ERROR;
+
+    OS_ListNodeInit(&timer->link, timer);
+    OS_ListNodeInit(&timer->expiredLink, timer);
+    timer->callback = callback;
+    timer->argument = argument;
+    timer->period = period;
+    timer->mode = mode;
+
+    return OS_TIMER_OK;
+}
+
+/* Sends a command to the timer service from a task */
+static OS_TimerState OS_TimerCommandSend(OS_Timer* timer, OS_TimerCommand command, uint32_t period) {
+    OS_TimerRequest request;
+
+    if (!timer)
+        return OS_TIMER_ERROR;
+
+    request.timer = timer;
+    request.task = OS_GetCurrentTask();
+    request.period = period;
+    request.command = command;
+    request.state = OS_TIMER_OK;
+
+    OS_REQUEST_SERVICE_ARG(SVC_TIMER, &request);
+
+    return request.state;
+}
+
+/* Applies a command to the timer service from an interrupt handler */
+static OS_TimerState OS_TimerCommandFromISR(OS_Timer* timer, OS_TimerCommand command) {
+    OS_TimerRequest request;
+    uint32_t interrupts;
+
+    if (!timer)
+        return OS_TIMER_ERROR;
+
+    request.timer = timer;
+    request.task = NULL;
+    request.period = 0;
+    request.command = command;
+    request.state = OS_TIMER_OK;
+
+    interrupts = OS_EnterCriticalFromISR();
+    OS_TimerService(&request);
+    OS_ExitCriticalFromISR(interrupts);
+
+    return request.state;
+}
+
+/**
+ * @brief Starts a timer: it expires after its period. An active timer is left unchanged.
+ *
+ * @param timer Pointer to the timer.
+ * @return OS_TimerState OS_TIMER_OK, or OS_TIMER_ERROR for a NULL timer.
+ */
+OS_TimerState OS_TimerStart(OS_Timer* timer) {
+    return OS_TimerCommandSend(timer, OS_TIMER_CMD_START, 0);
+}
+
+/**
+ * @brief Restarts a timer, active or not: it expires one period from now.
+ *
+ * @param timer Pointer to the timer.
+ * @return OS_TimerState OS_TIMER_OK, or OS_TIMER_ERROR for a NULL timer.
+ */
+OS_TimerState OS_TimerReset(OS_Timer* timer) {
+    return OS_TimerCommandSend(timer, OS_TIMER_CMD_RESET, 0);
+}
+
+/**
+ * @brief Stops a timer. A callback pending for an expiry that already occurred is dropped.
+ *
+ * @param timer Pointer to the timer.
+ * @return OS_TimerState OS_TIMER_OK, or OS_TIMER_ERROR for a NULL timer.
+ */
+OS_TimerState OS_TimerStop(OS_Timer* timer) {
+    return OS_TimerCommandSend(timer, OS_TIMER_CMD_STOP, 0);
+}
+
+/**
+ * @brief Changes the period of a timer and restarts it with the new period.
+ *
+ * @param timer Pointer to the timer.
+ * @param period New period in ticks, at least 1.
+ * @return OS_TimerState OS_TIMER_OK, or OS_TIMER_ERROR for a NULL timer or a zero period.
+ */
+OS_TimerState OS_TimerChangePeriod(OS_Timer* timer, uint32_t period) {
+    if (!period)
+        return OS_TIMER_ERROR;
+
+    return OS_TimerCommandSend(timer, OS_TIMER_CMD_CHANGE_PERIOD, period);
+}
+
+/**
+ * @brief Starts a timer from an interrupt handler (see OS_TimerStart).
+ */
+OS_TimerState OS_TimerStartFromISR(OS_Timer* timer) {
+    return OS_TimerCommandFromISR(timer, OS_TIMER_CMD_START);
+}
+
+/**
+ * @brief Restarts a timer from an interrupt handler (see OS_TimerReset).
+ */
+OS_TimerState OS_TimerResetFromISR(OS_Timer* timer) {
+    return OS_TimerCommandFromISR(timer, OS_TIMER_CMD_RESET);
+}
+
+/**
+ * @brief Stops a timer from an interrupt handler (see OS_TimerStop).
+ */
+OS_TimerState OS_TimerStopFromISR(OS_Timer* timer) {
+    return OS_TimerCommandFromISR(timer, OS_TIMER_CMD_STOP);
+}
+
+/**
+ * @brief Checks whether a timer is armed.
+ *
+ * @param timer Pointer to the timer.
+ * @return uint8_t 1 if the timer will expire, 0 if it is stopped or a one-shot timer that expired.
+ */
+uint8_t OS_TimerIsActive(OS_Timer* timer) {
+    return (timer->link.Container != NULL);
+}
+
+/**
+ * @brief Kernel side of the timer service (SVC handler, or FromISR in a critical section).
+ *
+ * @param request Timer service arguments, state and the taken timer are written back.
+ * @return uint8_t 1 if the daemon blocked and the scheduling decision has to be taken again.
+ */
+uint8_t OS_TimerService(OS_TimerRequest* request) {
+    OS_Timer* timer = request->timer;
+
+    switch (request->command) {
+        case OS_TIMER_CMD_START:
+            if (timer->link.Container == NULL) {
+                OS_TimerArm(timer);
+            }
+        break;
+
+        case OS_TIMER_CMD_RESET:
+            OS_TimerArm(timer);
+        break;
+
+        case OS_TIMER_CMD_STOP:
+            OS_TimerDisarm(timer);
+        break;
+
+        case OS_TIMER_CMD_CHANGE_PERIOD:
+            timer->period = request->period;
+            OS_TimerArm(timer);
+        break;
+
+        case OS_TIMER_CMD_TAKE:
+            if (ExpiredTimers.Head != NULL) {
+                request->timer = (OS_Timer*)ExpiredTimers.Head->Owner;
+                OS_ListRemove(ExpiredTimers.Head);
+                request->state = OS_TIMER_OK;
+            } else {
+                request->state = OS_TIMER_BLOCKED;
+                OS_WaitQueueBlock(&DaemonQueue, request->task, request, OS_WAIT_FOREVER);
+                return 1;
+            }
+        break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Expires the timers on every tick (called by OS_UpdateNoOfTicks).
+ *
+ * Only the head of the delta list is decremented. An auto-reload timer that
+ * expires again before its callback ran gets a single callback.
+ */
+void OS_TimerTick(void) {
+    OS_ListNode* head = ActiveTimers.Head;
+
+    if (head == NULL)
+        return;
+
+    head->Value--;
+
+    // Expire the head and every timer sharing its expiry tick
+    while ((head != NULL) && (head->Value == 0)) {
+        OS_Timer* timer = (OS_Timer*)head->Owner;
+
+        OS_ListRemove(head);
+        if (timer->mode == OS_TIMER_AUTO_RELOAD) {
+            OS_ListInsertDelta(&ActiveTimers, &timer->link, timer->period);
+        }
+        if (timer->expiredLink.Container == NULL) {
+            OS_ListInsertTail(&ExpiredTimers, &timer->expiredLink);
+        }
+
+        head = ActiveTimers.Head;
+    }
+
+    // Wake the daemon, the tick takes the scheduling decision
+    if (ExpiredTimers.Head != NULL) {
+        OS_WaitQueueWake(&DaemonQueue);
+    }
+}
+
+/**
+ * @brief Returns the ticks until the first timer expiry, or 0xFFFFFFFF if no timer is armed.
+ */
+uint32_t OS_TimerGetExpectedIdleTicks(void) {
+    if (ActiveTimers.Head == NULL)
+        return 0xFFFFFFFF;
+
+    return ActiveTimers.Head->Value;
+}
+
+/**
+ * @brief Accounts for ticks that elapsed while the periodic tick was suppressed.
+ *
+ * @param ticks Number of elapsed ticks, never past the first expiry.
+ */
+void OS_TimerStepTickCount(uint32_t ticks) {
+    OS_ListNode* head = ActiveTimers.Head;
+
+    if (head == NULL)
+        return;
+
+    // The expiry tick itself is processed by OS_TimerTick
+    if (ticks >= head->Value) {
+        ticks = head->Value - 1;
+    }
+    head->Value -= ticks;
+}
+
+#endif /* OS_TIMERS_ENABLED */
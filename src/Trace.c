@@ -0,0 +1,55 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Scheduler event trace buffer. The records themselves are written by the
+  inline OS_TraceRecordEvent of Trace.h; this file fills the self-describing
+  header and the task name table read by the host decoder.
+*/
+
+#include <string.h>
+#include "Trace.h"
+
+#if OS_TRACE_ENABLED
+OS_Trace OS_TraceData;                 // Trace buffer, dumped for tools/TraceDecode.py
+
+/**
+ * @brief Clears the trace buffer and fills its header, called by OS_Init.
+ */
+void OS_TraceInit(void) {
+    memset(&OS_TraceData, 0, sizeof(OS_TraceData));
+
+    OS_TraceData.Version = OS_TRACE_VERSION;
+    OS_TraceData.MaxTasks = OS_TRACE_MAX_TASKS;
+    OS_TraceData.NameLength = OS_TRACE_NAME_LENGTH;
+    OS_TraceData.Capacity = OS_TRACE_BUFFER_SIZE;
+    OS_TraceData.Frequency = OS_CYCLE_COUNTER_FREQ_IN_HZ;
+    OS_TraceData.Written = 0;
+
+    // Written last: the decoder only accepts a complete header
+    OS_TraceData.Magic = OS_TRACE_MAGIC;
+}
+
+/**
+ * @brief Gives a created task its trace id and records its name.
+ *
+ * @param Task Pointer to the task control block (TCB), the id is its creation index.
+ */
+void OS_TraceTaskCreated(OS_TCB* Task) {
+    uint8_t Id = OS_ControlBlock.NoOfCreatedTasks;
+
+    Task->TraceId = (Id < OS_TRACE_NO_TASK) ? Id : (OS_TRACE_NO_TASK - 1);
+
+    if (Id >= OS_TRACE_MAX_TASKS)
+        return;
+
+    // Truncated name, the table was cleared by OS_TraceInit so it stays NUL terminated
+    for (uint8_t i = 0; (i < (OS_TRACE_NAME_LENGTH - 1)) && (Task->TaskName[i] != 0); i++) {
+        OS_TraceData.TaskNames[Id][i] = Task->TaskName[i];
+    }
+}
+#endif
@@ -38,4 +38,81 @@
 // Enable/disable the idle task hook
 #define OS_IDLE_TASK_HOOK_ENABLED     1
 
+// Enable/disable tickless idle: while only the idle task is ready, SysTick is stretched
+// up to the next delayed task wake-up (skipped ticks do not call the tick hook)
+#define OS_TICKLESS_IDLE_ENABLED      0
+
+// Minimum number of idle ticks worth stopping the periodic tick for
+#define OS_TICKLESS_MIN_IDLE_TICKS    2
+
+// Scheduler implementations
+#define OS_SCHED_SORTED_TABLE         0  // Sorted task table rebuilt into the ready queue on every service call
+#define OS_SCHED_PRIORITY_BITMAP      1  // Per-priority ready lists with an O(1) priority bitmap lookup
+#define OS_SCHED_EDF                  2  // Earliest deadline first: ready tasks in a binary heap ordered by
+                                         // absolute deadline, tasks without RelativeDeadline run by priority
+                                         // below every task with a deadline
+
+// Scheduler used by the kernel
+#ifndef OS_SCHEDULER_POLICY
+#define OS_SCHEDULER_POLICY           OS_SCHED_PRIORITY_BITMAP
+#endif
+
+// Number of cores scheduling the tasks (1 to 8, OS_SCHED_PRIORITY_BITMAP only): every core runs the
+// head of its own ready lists, a task made ready goes to the core running the lowest priority work
+// its OS_TCB.Affinity allows, and a core takes ready tasks of higher priority than its own from the
+// other cores (work stealing). The POSIX port simulates the cores with threads
+#ifndef OS_NUM_CORES
+#define OS_NUM_CORES                  1
+#endif
+
+// Default round robin time slice in ticks: a task runs this long before a ready task of the same
+// priority takes over (per task through OS_TCB.TimeSlice, not used by OS_SCHED_SORTED_TABLE)
+#define OS_TIME_SLICE_TICKS           1
+
+// Enable/disable priority inheritance: a mutex owner runs at the priority of its highest priority waiter
+#define OS_MUTEX_PRIORITY_INHERITANCE 1
+
+// Enable/disable the software timer service: timers expire on the kernel tick and their
+// callbacks run in the timer daemon task (OS_TimerCreate, OS_TimerStart, ...)
+#define OS_TIMERS_ENABLED             1
+
+// Priority of the timer daemon task, callbacks are delayed by the ready tasks of higher priority
+#define OS_TIMER_TASK_PRIORITY        1
+
+// Stack size of the timer daemon task in bytes, shared by all the timer callbacks
+#define OS_TIMER_TASK_STACK_SIZE      512
+
+// Enable/disable kernel cycle profiling using the CPU cycle counter
+#ifndef OS_PROFILING_ENABLED
+#define OS_PROFILING_ENABLED          0
+#endif
+
+// Enable/disable runtime statistics: CPU time, switches-in and preemptions of every task,
+// measured with the cycle counter at each context switch (OS_GetTaskStats, OS_GetSystemStats)
+#define OS_RUNTIME_STATS_ENABLED      0
+
+// Enable/disable the scheduler event trace: compact time stamped records kept in a RAM ring
+// buffer (OS_TraceData), converted to Chrome trace / Perfetto JSON by tools/TraceDecode.py
+#define OS_TRACE_ENABLED              0
+
+// Records kept by the trace ring buffer (8 bytes each), a power of two
+#define OS_TRACE_BUFFER_SIZE          1024
+
+// Enable/disable stack profiling: task stacks are painted at creation so that their
+// high-water mark can be measured and recommended stack sizes reported
+#define OS_STACK_PROFILING_ENABLED    0
+
+// Safety margin added to the measured high-water mark in the recommended stack sizes (percent)
+#define OS_STACK_MARGIN_PERCENT       25
+
+// Highest interrupt priority masked by the kernel (0 = highest, 15 = lowest on the STM32F1):
+// interrupts of priority OS_KERNEL_INTERRUPT_PRIORITY to 15 may call the FromISR services and
+// are masked by the critical sections, SVC runs just above at OS_KERNEL_INTERRUPT_PRIORITY - 1,
+// and interrupts of priority 0 to OS_KERNEL_INTERRUPT_PRIORITY - 2 are never masked by the kernel
+// (they must not call it)
+#define OS_KERNEL_INTERRUPT_PRIORITY  5
+
+// Run tasks in privileged mode (needed to access core peripherals such as DWT or SysTick from tasks)
+#define OS_PRIVILEGED_TASKS           0
+
 #endif /* INC_CONFIG_H_ */
@@ -18,20 +18,36 @@
 #define OS_EVENT_GROUP_OK               0
 #define OS_EVENT_GROUP_TIMEOUT          1
 #define OS_EVENT_GROUP_ERROR            2
+#define OS_EVENT_GROUP_BLOCKED          3    // Internal: the wait service blocked the caller
 
 typedef uint32_t OS_EventGroupBits;  // 32-bit event group bits
 
 /** Structure for Event Group */
 typedef struct {
     OS_EventGroupBits bits;              // Holds the event flags
-    OS_TCB* waitingTasks[10];            // Array of tasks waiting on this event group
-    uint8_t numWaitingTasks;             // Number of tasks currently waiting
+    OS_WaitQueue waiters;                // Tasks waiting on this event group
 } OS_EventGroup;
 
+/** Arguments of the event group services, passed by address in R0 */
+typedef struct {
+    OS_EventGroup* eventGroup;           // Event group to wait on or to set bits in
+    OS_TCB* task;                        // Waiting task
+    OS_EventGroupBits bits;              // Bits waited for, or bits to set
+    uint8_t waitForAllBits;              // 1 to wait for all the bits, 0 for any of them
+    uint8_t clearOnExit;                 // 1 to clear the bits waited for when the wait succeeds
+    uint32_t timeout;                    // Ticks to wait, 0 to return at once or OS_WAIT_FOREVER
+    uint8_t state;                       // Result of the service
+} OS_EventGroupRequest;
+
 /** Event Group function prototypes */
 void OS_InitEventGroup(OS_EventGroup* eventGroup);
-uint8_t OS_WaitForEventBits(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits, uint8_t waitForAllBits, uint32_t timeout);
+uint8_t OS_WaitForEventBits(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits, uint8_t waitForAllBits, uint8_t clearOnExit, uint32_t timeout);
 void OS_SetEventBits(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits);
+void OS_SetEventBitsFromISR(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits);
 void OS_ClearEventBits(OS_EventGroup* eventGroup, OS_EventGroupBits eventBits);
 
+/* Kernel side of the services, called from the SVC handler */
+uint8_t OS_EventGroupWaitService(OS_EventGroupRequest* request);
+uint8_t OS_EventGroupSetService(OS_EventGroupRequest* request);
+
 #endif // EVENT_GROUP_H
@@ -0,0 +1,51 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Intrusive circular doubly linked lists used by the kernel to link task
+  control blocks without any extra storage (ready lists, wait lists, ...).
+  Delta lists (delay list, timer list) keep in each node the ticks left after
+  its predecessor, so only their head has to be touched on a tick.
+*/
+#ifndef INC_LIST_H_
+#define INC_LIST_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct OS_List;
+
+/** List node, embedded in the object that is linked */
+typedef struct OS_ListNode {
+    struct OS_ListNode* Next;      // Next node in the list (circular)
+    struct OS_ListNode* Prev;      // Previous node in the list (circular)
+    struct OS_List* Container;     // List holding the node, NULL if not linked
+    void* Owner;                   // Object embedding the node (e.g. OS_TCB)
+    uint32_t Value;                // Sort key used by ordered insertion
+} OS_ListNode;
+
+/** List head, the tail is always Head->Prev */
+typedef struct OS_List {
+    OS_ListNode* Head;             // First node, NULL if the list is empty
+} OS_List;
+
+/**
+ * @brief Returns the owner of the first node of a list, or NULL if it is empty.
+ */
+#define OS_LIST_HEAD_OWNER(List)    (((List)->Head != NULL) ? (List)->Head->Owner : NULL)
+
+void OS_ListInit(OS_List* List);
+void OS_ListNodeInit(OS_ListNode* Node, void* Owner);
+void OS_ListInsertTail(OS_List* List, OS_ListNode* Node);
+void OS_ListInsertBefore(OS_List* List, OS_ListNode* Node, OS_ListNode* Position);
+void OS_ListInsertOrdered(OS_List* List, OS_ListNode* Node);
+void OS_ListInsertDelta(OS_List* List, OS_ListNode* Node, uint32_t Value);
+void OS_ListRemove(OS_ListNode* Node);
+void OS_ListRemoveDelta(OS_ListNode* Node);
+void OS_ListRotate(OS_List* List);
+
+#endif /* INC_LIST_H_ */
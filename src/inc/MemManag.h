@@ -15,6 +15,56 @@
 
 #include <Tasks.h>
 
+/**
+ * @brief Rounds a block size up to a whole number of pointers, the smallest block holds the free list link.
+ */
+#define OS_POOL_BLOCK_SIZE(Size)   ((((Size) + sizeof(void*) - 1) / sizeof(void*)) * sizeof(void*))
+/**
+ * @brief Number of pointer-aligned words of storage needed by a pool, to declare it as void* Memory[...].
+ */
+#define OS_POOL_WORDS(Size, NoOfBlocks)   ((OS_POOL_BLOCK_SIZE(Size) / sizeof(void*)) * (NoOfBlocks))
+
+/**
+ * @brief Word written over the whole task stack at creation when OS_STACK_PROFILING_ENABLED is set.
+ */
+#define OS_STACK_PAINT_PATTERN     0xA5A5A5A5
+
+/** Called by OS_ReportStackUsage for every created task */
+typedef void (*OS_StackReportCallback)(OS_TCB* Task, uint32_t HighWaterMark, uint32_t RecommendedSize);
+
+/** Free block of a pool: the link is stored in the block itself */
+typedef struct OS_PoolBlock {
+    struct OS_PoolBlock* Next;           // Next free block, NULL at the end of the list
+} OS_PoolBlock;
+
+/** Fixed-size block pool */
+typedef struct {
+    OS_PoolBlock* volatile FreeList;     // First free block
+    uint8_t* Start;                      // First block of the storage
+    uint8_t* End;                        // End of the storage
+    uint32_t BlockSize;                  // Size of a block in bytes, pointer aligned
+    uint32_t NoOfBlocks;                 // Number of blocks of the pool
+    volatile uint32_t InUse;             // Blocks currently allocated
+    volatile uint32_t HighWaterMark;     // Maximum of InUse since the initialization
+    volatile uint32_t Failures;          // Allocations that found the pool empty
+} OS_MemPool;
+
+/** Snapshot of the pool statistics */
+typedef struct {
+    uint32_t InUse;
+    uint32_t HighWaterMark;
+    uint32_t Failures;
+} OS_MemPoolStats;
+
 OS_ErrorStatus OS_CreateMainStack();
 OS_ErrorStatus OS_CreateStack(OS_TCB* Task);
+#if OS_STACK_PROFILING_ENABLED
+uint32_t OS_GetStackHighWaterMark(OS_TCB* Task);
+void OS_ReportStackUsage(OS_StackReportCallback Callback);
+#endif
+
+OS_ErrorStatus OS_PoolInit(OS_MemPool* Pool, void* Memory, uint32_t BlockSize, uint32_t NoOfBlocks);
+void* OS_PoolAlloc(OS_MemPool* Pool);
+OS_ErrorStatus OS_PoolFree(OS_MemPool* Pool, void* Block);
+void OS_PoolGetStats(OS_MemPool* Pool, OS_MemPoolStats* Stats);
 #endif /* INC_MEMMANAG_H_ */
@@ -13,7 +13,7 @@
 #define MUTEX_H
 
 #include "Tasks.h"
-#include "FIFO.h"
+#include "List.h"
 
 /** Enum for mutex state */
 typedef enum {
@@ -24,17 +24,29 @@ typedef enum {
 } OS_MutexState;
 
 /** Mutex structure */
-typedef struct {
+typedef struct OS_Mutex {
     int8_t isLocked;                          // Mutex lock flag (1 = locked, 0 = available)
     uint8_t waitingCount;                     // Number of tasks waiting for the mutex
     OS_TCB* owner;                            // Current owner of the mutex
-    OS_TCB* waitingQueue[100];                // Waiting queue for tasks
-    OS_TCB* waitingQueueBuffer[100];          // FIFO queue buffer
+    OS_WaitQueue waiters;                     // Tasks blocked on the mutex, highest priority first
+    OS_ListNode heldLink;                     // Link in the list of mutexes held by the owner
 } OS_Mutex;
 
+/** Arguments of the mutex services, passed by address in R0 */
+typedef struct {
+    OS_Mutex* mutex;                          // Mutex to acquire or release
+    OS_TCB* task;                             // Task acquiring the mutex
+    OS_MutexState state;                      // Result of the service
+} OS_MutexRequest;
+
 /* Function prototypes */
 OS_MutexState OS_InitMutex(OS_Mutex* mutex);
 OS_MutexState OS_AcquireMutex(OS_Mutex* mutex, OS_TCB* task);
 OS_MutexState OS_ReleaseMutex(OS_Mutex* mutex);
 
+/* Kernel side of the services, called from the SVC handler */
+uint8_t OS_MutexAcquireService(OS_MutexRequest* request);
+uint8_t OS_MutexReleaseService(OS_MutexRequest* request);
+void OS_MutexWaitCancel(OS_TCB* task);
+
 #endif // MUTEX_H
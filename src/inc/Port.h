@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "Config.h"
 #include "stm32f103xb.h"
 #include "core_cm3.h"
 
@@ -45,8 +46,89 @@
  * @brief Macro to trigger a PendSV exception.
  */
 #define OS_TRIGGER_PENDSV()           SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
+/**
+ * @brief Macro to request a kernel service (SVC exception).
+ */
+#define OS_REQUEST_SERVICE(SVC_ID)  __asm volatile ("SVC %[SVCid]" : : [SVCid] "i" (SVC_ID));
+/**
+ * @brief Macro to request a kernel service passing the target task in R0.
+ */
+#define OS_REQUEST_SERVICE_ARG(SVC_ID, Arg)  __asm volatile ("MOV R0, %[SVCarg] \n\t SVC %[SVCid]" : : [SVCid] "i" (SVC_ID), [SVCarg] "r" (Arg) : "r0", "memory");
+/**
+ * @brief Macro to get the SVC number from the stacked frame (immediate of the SVC instruction before the stacked PC).
+ */
+#define OS_SVC_GET_ID(Stack_Pointer)   (*((uint8_t*)(((uint8_t*)(Stack_Pointer)[6]) - 2)))
+/**
+ * @brief Macro to get the service argument from the stacked frame (stacked R0).
+ */
+#define OS_SVC_GET_ARG(Stack_Pointer)  ((void*)(Stack_Pointer)[0])
+/**
+ * @brief Macro to wait for an event in low power mode.
+ */
+#define OS_WAIT_FOR_EVENT()           __asm("WFE")
+/**
+ * @brief Macro to count the leading zero bits of a 32-bit word (single CLZ instruction).
+ */
+#define OS_COUNT_LEADING_ZEROS(x)     __CLZ(x)
+/**
+ * @brief Macro to enable the DWT free running cycle counter.
+ */
+#define OS_CYCLE_COUNTER_INIT()       do { CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; \
+                                           DWT->CYCCNT = 0; \
+                                           DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; } while (0)
+/**
+ * @brief Macro to read the DWT cycle counter (privileged access only).
+ */
+#define OS_GET_CYCLE_COUNT()          (DWT->CYCCNT)
+/**
+ * @brief Frequency of the cycle counter.
+ */
+#define OS_CYCLE_COUNTER_FREQ_IN_HZ   OS_CPU_CLOCK_FREQ_IN_HZ
+/**
+ * @brief Macros for lock-free updates of a 32-bit word (LDREX/STREX), usable unprivileged and from ISRs.
+ *        The store returns 0 on success; any exception between the load and the store makes it fail.
+ */
+#define OS_LOAD_EXCLUSIVE(Address)          __LDREXW((volatile uint32_t*)(Address))
+#define OS_STORE_EXCLUSIVE(Value, Address)  __STREXW((uint32_t)(uintptr_t)(Value), (volatile uint32_t*)(Address))
+#define OS_CLEAR_EXCLUSIVE()                __CLREX()
+/**
+ * @brief Orders the memory accesses before it against those after it, for data shared without a lock.
+ */
+#define OS_MEMORY_BARRIER()                 __DMB()
+/**
+ * @brief BASEPRI value masking the kernel interrupt band (OS_KERNEL_INTERRUPT_PRIORITY and below).
+ */
+#define OS_KERNEL_BASEPRI                   (OS_KERNEL_INTERRUPT_PRIORITY << (8 - __NVIC_PRIO_BITS))
+/**
+ * @brief Macros to mask the kernel interrupt band (BASEPRI, privileged only), nesting safe.
+ *        OS_MASK_INTERRUPTS returns the previous state to hand to OS_RESTORE_INTERRUPTS, 0 is unmasked.
+ */
+#define OS_MASK_INTERRUPTS()                ({ uint32_t OS_PreviousMask = __get_BASEPRI(); \
+                                               __set_BASEPRI_MAX(OS_KERNEL_BASEPRI); __DSB(); __ISB(); \
+                                               OS_PreviousMask; })
+#define OS_RESTORE_INTERRUPTS(State)        __set_BASEPRI(State)
+/**
+ * @brief Tasks can only write BASEPRI when they run privileged, otherwise critical sections go through SVC.
+ */
+#define OS_TASKS_CAN_MASK_INTERRUPTS        OS_PRIVILEGED_TASKS
+/**
+ * @brief Index of the core running the caller, the Cortex-M3 is a single core.
+ */
+#define OS_CORE_ID()                        0U
+
+#if (OS_KERNEL_INTERRUPT_PRIORITY < 2) || (OS_KERNEL_INTERRUPT_PRIORITY > ((1 << __NVIC_PRIO_BITS) - 1))
+#error "OS_KERNEL_INTERRUPT_PRIORITY must leave room for SVC above it and fit the NVIC priority bits"
+#endif
+
+#if OS_NUM_CORES > 1
+#error "The Cortex-M3 port runs a single core: set OS_NUM_CORES to 1"
+#endif
 
 
 void OS_HwInit();
 void OS_StartTimer();
+#if OS_TICKLESS_IDLE_ENABLED
+void OS_TicklessEnter(uint32_t ExpectedIdleTicks);
+void OS_TicklessExit();
+#endif
 #endif /* INC_CORTEXM_OS_PORTING_H_ */
@@ -0,0 +1,60 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Zero-copy message queues. Messages are pointers to buffers owned by the
+  application: sending a pointer hands the buffer over to the receiver, the
+  payload itself is never copied. A queue of length 1 is a mailbox.
+*/
+
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "Tasks.h"
+
+/** Enum for queue states */
+typedef enum {
+    OS_QUEUE_OK,                   // Message sent or received
+    OS_QUEUE_FULL,                 // No room and no time to wait
+    OS_QUEUE_EMPTY,                // No message and no time to wait
+    OS_QUEUE_TIMEOUT,              // Timeout expired while blocked
+    OS_QUEUE_BLOCKED,              // Internal: the service blocked the caller
+    OS_QUEUE_INIT_OK,              // Queue initialized successfully
+    OS_QUEUE_INIT_ERROR            // Invalid buffer or length
+} OS_QueueState;
+
+/** Queue structure: circular buffer of message pointers plus the blocked tasks */
+typedef struct {
+    void** base;                   // Storage of the message pointers
+    void** head;                   // Oldest message
+    void** tail;                   // Next free slot
+    uint32_t length;               // Capacity in messages
+    uint32_t counter;              // Messages currently queued
+    OS_WaitQueue senders;          // Tasks blocked on a full queue
+    OS_WaitQueue receivers;        // Tasks blocked on an empty queue
+} OS_Queue;
+
+/** Arguments of the queue services, passed by address in R0 */
+typedef struct {
+    OS_Queue* queue;               // Queue to send to or receive from
+    OS_TCB* task;                  // Calling task
+    void* message;                 // Message sent, or message received
+    uint32_t timeout;              // Ticks to wait, 0 to return at once or OS_WAIT_FOREVER
+    OS_QueueState state;           // Result of the service
+} OS_QueueRequest;
+
+/* Function prototypes */
+OS_QueueState OS_InitQueue(OS_Queue* queue, void** buffer, uint32_t length, OS_WaitOrder order);
+OS_QueueState OS_QueueSend(OS_Queue* queue, void* message, uint32_t timeout);
+OS_QueueState OS_QueueSendFromISR(OS_Queue* queue, void* message);
+OS_QueueState OS_QueueReceive(OS_Queue* queue, void** message, uint32_t timeout);
+
+/* Kernel side of the services, called from the SVC handler */
+uint8_t OS_QueueSendService(OS_QueueRequest* request);
+uint8_t OS_QueueReceiveService(OS_QueueRequest* request);
+
+#endif // QUEUE_H
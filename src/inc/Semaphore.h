@@ -12,7 +12,6 @@
 #ifndef SEMAPHORE_H
 #define SEMAPHORE_H
 
-#include "FIFO.h"
 #include "Tasks.h"
 
 /** Enum for semaphore states */
@@ -24,17 +23,30 @@ typedef enum {
 } OS_SemaphoreState;
 
 /** Semaphore structure */
-typedef struct {
+typedef struct OS_Semaphore {
     int32_t count;                     // Semaphore count (number of available resources)
     uint8_t waitingCount;              // Number of tasks waiting for the semaphore
+    uint8_t isSignal;                  // Created with a count of 0: no owner, releases signal events
     OS_TCB* owner;                     // Current owner of the semaphore
-    OS_tBuffer waitingQueue;           // FIFO buffer for waiting tasks
-    OS_TCB* waitingQueueBuffer[100];   // Buffer for task control blocks waiting for the semaphore
+    OS_WaitQueue waiters;              // Tasks blocked on the semaphore, in arrival order
 } OS_Semaphore;
 
+/** Arguments of the semaphore services, passed by address in R0 */
+typedef struct {
+    OS_Semaphore* semaphore;           // Semaphore to acquire or release
+    OS_TCB* task;                      // Task acquiring the semaphore
+    OS_SemaphoreState state;           // Result of the service
+} OS_SemaphoreRequest;
+
 /** Semaphore function prototypes */
 OS_SemaphoreState OS_InitSemaphore(OS_Semaphore* semaphore, uint8_t initialCount);
 OS_SemaphoreState OS_AcquireSemaphore(OS_Semaphore* semaphore, OS_TCB* task);
 OS_SemaphoreState OS_ReleaseSemaphore(OS_Semaphore* semaphore);
+OS_SemaphoreState OS_ReleaseSemaphoreFromISR(OS_Semaphore* semaphore);
+
+/* Kernel side of the services, called from the SVC handler */
+uint8_t OS_SemaphoreAcquireService(OS_SemaphoreRequest* request);
+uint8_t OS_SemaphoreReleaseService(OS_SemaphoreRequest* request);
+void OS_SemaphoreWaitCancel(OS_TCB* task);
 
 #endif // SEMAPHORE_H
@@ -0,0 +1,66 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Stream buffers: byte streams from one interrupt handler to one task. The
+  bytes are copied in and out in bulk, or written in place by a DMA through a
+  reserved region, without a critical section. The reader blocks until the
+  trigger level is reached, so a task is woken once per burst instead of once
+  per byte.
+*/
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include "Tasks.h"
+
+/** Enum for stream buffer states */
+typedef enum {
+    OS_STREAM_OK,                  // Trigger level reached
+    OS_STREAM_EMPTY,               // Below the trigger level and no time to wait
+    OS_STREAM_TIMEOUT,             // Timeout expired while blocked
+    OS_STREAM_BLOCKED,             // Internal: the service blocked the caller
+    OS_STREAM_INIT_OK,             // Stream buffer initialized successfully
+    OS_STREAM_INIT_ERROR           // Invalid storage, size or trigger level
+} OS_StreamState;
+
+/** Stream buffer structure: byte ring indexed by free running counters plus the blocked reader
+ *  Only the writer moves tail and only the reader moves head, the bytes stored are tail - head.
+ */
+typedef struct {
+    uint8_t* base;                 // Storage of the bytes
+    uint32_t size;                 // Capacity in bytes, a power of two
+    volatile uint32_t head;        // Bytes read since initialization
+    volatile uint32_t tail;        // Bytes written since initialization
+    uint32_t triggerLevel;         // Bytes the reader waits for
+    volatile uint32_t wakeLevel;   // Bytes the blocked reader needs, 0 while no reader waits
+    OS_WaitQueue reader;           // Task blocked below the trigger level
+} OS_StreamBuffer;
+
+/** Arguments of the stream buffer receive service, passed by address in R0 */
+typedef struct {
+    OS_StreamBuffer* stream;       // Stream buffer to wait on
+    OS_TCB* task;                  // Calling task
+    uint32_t level;                // Bytes waited for
+    uint32_t timeout;              // Ticks to wait, 0 to return at once or OS_WAIT_FOREVER
+    OS_StreamState state;          // Result of the service
+} OS_StreamRequest;
+
+/* Function prototypes */
+OS_StreamState OS_InitStreamBuffer(OS_StreamBuffer* stream, uint8_t* buffer, uint32_t size, uint32_t triggerLevel);
+OS_StreamState OS_StreamSetTriggerLevel(OS_StreamBuffer* stream, uint32_t triggerLevel);
+uint32_t OS_StreamSendFromISR(OS_StreamBuffer* stream, const void* data, uint32_t length);
+uint32_t OS_StreamReserve(OS_StreamBuffer* stream, uint8_t** region);
+uint32_t OS_StreamCommitFromISR(OS_StreamBuffer* stream, uint32_t length);
+uint32_t OS_StreamReceive(OS_StreamBuffer* stream, void* data, uint32_t length, uint32_t timeout);
+uint32_t OS_StreamBytesAvailable(const OS_StreamBuffer* stream);
+uint32_t OS_StreamSpaceAvailable(const OS_StreamBuffer* stream);
+
+/* Kernel side of the services, called from the SVC handler */
+uint8_t OS_StreamReceiveService(OS_StreamRequest* request);
+
+#endif // STREAM_BUFFER_H
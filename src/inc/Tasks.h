@@ -12,8 +12,34 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "Config.h"
+#include "List.h"
 
 
+struct OS_Mutex;
+struct OS_Semaphore;
+
+// Ordering of the tasks blocked on a synchronization object
+typedef enum {
+    OS_WAIT_FIFO,                  // Tasks are served in arrival order
+    OS_WAIT_PRIORITY               // Highest priority first, FIFO among equal priorities
+} OS_WaitOrder;
+
+// Tasks blocked on a synchronization object, linked through their WaitLink
+typedef struct {
+    OS_List Tasks;                 // Blocked tasks, the head is served first
+    OS_WaitOrder Order;            // Ordering of the blocked tasks
+} OS_WaitQueue;
+
+#if OS_RUNTIME_STATS_ENABLED
+// Runtime accounting of a task, updated at each context switch
+typedef struct {
+    uint64_t RunTime;              // Cycle counter units spent running the task
+    uint32_t SwitchesIn;           // Times the task was switched in
+    uint32_t Preemptions;          // Times the task was switched out while still ready
+} OS_TaskRuntime;
+#endif
+
 // Enumeration for task auto-start options
 typedef enum {
     noAutoStart,
@@ -21,11 +47,17 @@ typedef enum {
 } OS_TaskAutoStart;
 
 // Structure defining a task
-typedef struct {
-    uint8_t Priority;              // Task priority
-    uint8_t TaskName[30];          // Name of the task
+typedef struct OS_TCB {
+    uint8_t Priority;              // Task priority (effective, may be raised by priority inheritance)
+    uint8_t BasePriority;          // Priority assigned at creation
+    char TaskName[30];             // Name of the task
     uint16_t StackSize;            // Size of the task stack
     void (*func)(void);            // Pointer to the task function
+    uint32_t RelativeDeadline;     // Ticks from each release to its deadline (OS_SCHED_EDF), 0 for none
+    uint16_t TimeSlice;            // Ticks run before round robin to an equal priority task, 0 for OS_TIME_SLICE_TICKS
+    uint8_t PreemptionThreshold;   // Only tasks of higher priority than this preempt the running task
+                                   // (OS_SCHED_PRIORITY_BITMAP), 0 for none (its own priority)
+    uint8_t Affinity;              // Cores the task may run on, bit n for core n, 0 for all (OS_NUM_CORES > 1)
     OS_TaskAutoStart AutoStart; // Auto-start option
     // Internal state management
     struct {
@@ -33,49 +65,110 @@ typedef struct {
             OS_TASK_BLOCKING_DISABLE,
             OS_TASK_BLOCKING_ENABLE
         } Blocking;                // Blocking state
-        uint32_t TicksCount;      // Tick count for waiting
+        uint32_t TicksCount;      // Number of ticks requested for waiting
     } Waiting;
-    uint32_t _S_PSP_Task;         // Start of task stack
-    uint32_t _E_PSP_Task;         // End of task stack
+    uint32_t Overruns;            // Periodic releases missed by OS_DelayUntil
+    uint16_t SliceLeft;           // Ticks left in the current time slice
+    struct OS_TCB* PreemptedNext; // Task preempted before it while holding a raised preemption threshold
+    uint8_t Core;                 // Core whose ready lists hold the task, or that ran it last
+    uintptr_t _S_PSP_Task;        // Start of task stack
+    uintptr_t _E_PSP_Task;        // End of task stack
     uint32_t* CurrentPSP;         // Current Process Stack Pointer
+    OS_ListNode ReadyLink;        // Link in the ready list of its priority
+    OS_ListNode DelayLink;        // Link in the delay list (Value holds the delta ticks)
+    OS_ListNode WaitLink;         // Link in the wait queue of a synchronization object (Value holds the priority)
+    OS_WaitQueue* WaitQueue;      // Wait queue the task is blocked in
+    void* WaitRequest;            // Arguments of the blocking service in progress, completed by the waker
+    struct OS_Mutex* WaitMutex;   // Mutex the task is blocked on
+    struct OS_Semaphore* WaitSemaphore; // Semaphore the task is blocked on
+    OS_List HeldMutexes;          // Mutexes owned by the task
     enum {
         OS_TASK_SUSPEND,
         OS_TASK_WAITING,
         OS_TASK_READY,
         OS_TASK_RUNNING
     } TaskState;                 // Current state of the task
+    uint32_t NotifyValue;         // Direct-to-task notification word
+    enum {
+        OS_TASK_NOTIFY_NONE,
+        OS_TASK_NOTIFY_WAITING,
+        OS_TASK_NOTIFY_PENDING
+    } NotifyState;               // Notification state of the task
+#if OS_RUNTIME_STATS_ENABLED
+    OS_TaskRuntime Runtime;       // CPU usage accounting
+#endif
+#if OS_TRACE_ENABLED
+    uint8_t TraceId;              // Id of the task in the trace records (creation order)
+#endif
+#if OS_SCHEDULER_POLICY == OS_SCHED_EDF
+    uint32_t AbsoluteDeadline;    // Tick the current job has to complete by
+    uint32_t DeadlineMisses;      // Jobs still running after their deadline
+    uint32_t ReadySequence;       // Insertion stamp, serves equal keys in round robin order
+    uint8_t ReadyIndex;           // Position in the ready heap, OS_EDF_NOT_READY when not ready
+    uint8_t DeadlineMissed;       // The current job was already counted as a miss
+#endif
 } OS_TCB;
 
+// Actions applied to the notification word of the notified task
+typedef enum {
+    OS_NOTIFY_SET_BITS,            // OR the value into the notification word
+    OS_NOTIFY_INCREMENT,           // Increment the notification word (value ignored)
+    OS_NOTIFY_OVERWRITE            // Replace the notification word with the value
+} OS_NotifyAction;
+
+// Results of a notification wait
+typedef enum {
+    OS_NOTIFY_OK,
+    OS_NOTIFY_TIMEOUT,
+    OS_NOTIFY_BLOCKED              // Internal: the wait service blocked the caller
+} OS_NotifyStatus;
+
+// Timeout value that waits without time limit
+#define OS_WAIT_FOREVER          0xFFFFFFFF
+
 // Enumeration for error statuses
 typedef enum {
     OS_OK,
     OS_EXCEED_AVAILABLE_STACK,
     FIFO_INIT_ERROR,
     TASK_CREATION_ERROR,
-	OS_PRIORITY_OUT_OF_RANGE
+	OS_PRIORITY_OUT_OF_RANGE,
+	OS_INVALID_PARAMETER
 } OS_ErrorStatus;
 
 // Stack padding definition
 #define OS_STACK_PADDING 8
 
-// Macro for service call request
-#define OS_REQUEST_SERVICE(SVC_ID)  __asm volatile ("SVC %[SVCid]" : : [SVCid] "i" (SVC_ID));
+#if (OS_NUM_CORES < 1) || (OS_NUM_CORES > 8)
+#error "OS_NUM_CORES must be 1 to 8, OS_TCB.Affinity holds one bit per core"
+#endif
+
+// Affinity mask of every core
+#define OS_ALL_CORES             ((uint8_t)((1U << OS_NUM_CORES) - 1))
+
+// Structure defining the scheduling state of a core
+typedef struct {
+    OS_TCB* CurrentTask;    // Pointer to the task running on the core
+    OS_TCB* NextTask;       // Pointer to the next task, switched in by PendSV
+} OS_Core;
 
 // Structure defining the operating system attributes
 typedef struct {
     uint8_t NoOfCreatedTasks;      // Number of created tasks
-    uint32_t _S_MSP_Task;          // Start of main stack
-    uint32_t _E_MSP_Task;          // End of main stack
-    uint32_t PSP_LastEnd;          // End of last PSP allocated
+    uintptr_t _S_MSP_Task;         // Start of main stack
+    uintptr_t _E_MSP_Task;         // End of main stack
+    uintptr_t PSP_LastEnd;         // End of last PSP allocated
     enum {
         OS_SUSPEND,
         OS_RUNNING
     } OS_Mode;                // Current OS mode
-    OS_TCB* CurrentTask;    // Pointer to the current task
-    OS_TCB* NextTask;       // Pointer to the next task
+    OS_Core Cores[OS_NUM_CORES]; // Running and next task of every core
     OS_TCB* TaskTable[100]; // Table of all tasks in the system
 } OS_Control;
 
+// PendSV calls OS_TaskSwitched before each context switch when something accounts for the switches
+#define OS_SWITCH_HOOK_ENABLED   (OS_RUNTIME_STATS_ENABLED || OS_TRACE_ENABLED)
+
 // Extern declaration for OS_StructOS
 extern OS_Control OS_ControlBlock;
 
@@ -86,19 +179,95 @@ typedef enum {
     SVC_WAITING,
     SVC_SUSPEND,
     SVC_ACQUIRE_MUTEX,
-    SVC_RELEASE_MUTEX
+    SVC_RELEASE_MUTEX,
+    SVC_DELAY,
+    SVC_TICKLESS_IDLE,
+    SVC_NOTIFY,
+    SVC_NOTIFY_WAIT,
+    SVC_QUEUE_SEND,
+    SVC_QUEUE_RECEIVE,
+    SVC_ACQUIRE_SEMAPHORE,
+    SVC_RELEASE_SEMAPHORE,
+    SVC_EVENT_WAIT,
+    SVC_EVENT_SET,
+    SVC_ENTER_CRITICAL,
+    SVC_EXIT_CRITICAL,
+    SVC_RUNTIME_STATS,
+    SVC_DELAY_UNTIL,
+    SVC_TIMER,
+    SVC_YIELD,
+    SVC_STREAM_RECEIVE
 } OS_SvcID; // Service Call IDs
 
+#if OS_PROFILING_ENABLED
+// Structure holding kernel cycle measurements
+typedef struct {
+    uint32_t SvcLastCycles;        // Cycles spent in the last service call
+    uint32_t SvcMaxCycles;         // Worst case cycles spent in a service call
+    uint32_t TickLastCycles;       // Cycles spent in the last SysTick handler
+    uint32_t TickMaxCycles;        // Worst case cycles spent in the SysTick handler
+    uint32_t MaskedLastCycles;     // Cycles the kernel interrupt band was masked by the last critical section
+    uint32_t MaskedMaxCycles;      // Worst case cycles the kernel interrupt band was masked by a critical section
+} OS_Profile;
+
+extern OS_Profile OS_ProfileData;
+#endif
+
+#if OS_RUNTIME_STATS_ENABLED
+// Statistics of one task
+typedef struct {
+    OS_TCB* Task;                  // Task measured
+    uint64_t RunTime;              // Cycle counter units spent running the task
+    uint32_t SwitchesIn;           // Times the task was switched in
+    uint32_t Preemptions;          // Times the task was switched out while still ready
+    uint16_t CpuUsage;             // Share of the total run time in 0.01 % (10000 = 100 %)
+} OS_TaskStats;
+
+// System wide statistics since OS_StartOS
+typedef struct {
+    uint64_t TotalTime;            // Cycle counter units elapsed, summed over all the tasks
+    uint64_t IdleTime;             // Cycle counter units spent in the idle task
+    uint32_t ContextSwitches;      // Context switches performed
+    uint16_t IdleUsage;            // Idle share of the total time in 0.01 %
+    uint8_t NoOfTasks;             // Entries written to the task statistics array
+} OS_SystemStats;
+#endif
+
 typedef void (*OS_IdleHookCallback)(void);
 typedef void (*OS_SysTickHook)(void);
 extern OS_SysTickHook SysTickHook;
 extern OS_IdleHookCallback IdleHookCallback;
 // Function declarations
+#if OS_SCHEDULER_POLICY == OS_SCHED_SORTED_TABLE
 void OS_SortSchedulerTable();
 void OS_UpdateReadyQueue();
+#endif
+#if OS_SCHEDULER_POLICY == OS_SCHED_EDF
+uint32_t OS_GetDeadlineMisses(void);
+#endif
+uint32_t OS_GetTickCount(void);
+OS_TCB* OS_GetCurrentTask(void);
+uint8_t OS_GetCoreId(void);
+void OS_ReadyListInsert(OS_TCB* Task);
+void OS_ReadyListRemove(OS_TCB* Task);
+void OS_ChangeTaskPriority(OS_TCB* Task, uint8_t Priority);
+void OS_WaitQueueInit(OS_WaitQueue* Queue, OS_WaitOrder Order);
+void OS_WaitQueueBlock(OS_WaitQueue* Queue, OS_TCB* Task, void* Request, uint32_t Timeout);
+OS_TCB* OS_WaitQueueWake(OS_WaitQueue* Queue);
+void OS_WaitQueueWakeTask(OS_TCB* Task);
+void OS_WaitQueueRemove(OS_TCB* Task);
 void OS_DecideNext();
+uint8_t OS_SwitchRequired();
+void OS_RescheduleFromISR(void);
+void OS_EnterCritical(void);
+void OS_ExitCritical(void);
+uint32_t OS_EnterCriticalFromISR(void);
+void OS_ExitCriticalFromISR(uint32_t State);
+uint32_t OS_GetAvoidedSwitchesPerSecond();
 void OS_SvcServices(uint32_t* Stack_Pointer);
 void OS_UpdateNoOfTicks();
+uint32_t OS_GetExpectedIdleTicks();
+void OS_StepTickCount(uint32_t NoOfTicks);
 void OS_RegisterSysTickHook(OS_SysTickHook callback);
 void OS_RegisterIdleHook(OS_IdleHookCallback callback);
 void OS_IdleTask();
@@ -107,6 +276,18 @@ OS_ErrorStatus OS_CreateTask(OS_TCB* Task);
 OS_ErrorStatus OS_ActivateTask(OS_TCB* Task);
 OS_ErrorStatus OS_TerminateTask(OS_TCB* Task);
 OS_ErrorStatus OS_DelayTask(OS_TCB* Task, uint32_t NoOfTicks);
+void OS_Yield(void);
+OS_ErrorStatus OS_DelayUntil(OS_TCB* Task, uint32_t* PreviousWakeTime, uint32_t Period);
+OS_ErrorStatus OS_Notify(OS_TCB* Task, uint32_t Value, OS_NotifyAction Action);
+OS_ErrorStatus OS_NotifyFromISR(OS_TCB* Task, uint32_t Value, OS_NotifyAction Action);
+OS_NotifyStatus OS_NotifyWait(uint32_t ClearOnExit, uint32_t* NotificationValue, uint32_t Timeout);
+#if OS_SWITCH_HOOK_ENABLED
+void OS_TaskSwitched(OS_TCB* Previous, OS_TCB* Next);
+#endif
+#if OS_RUNTIME_STATS_ENABLED
+OS_ErrorStatus OS_GetTaskStats(OS_TCB* Task, OS_TaskStats* Stats);
+OS_ErrorStatus OS_GetSystemStats(OS_SystemStats* Stats, OS_TaskStats* TaskStats, uint8_t MaxTasks);
+#endif
 OS_ErrorStatus OS_StartOS();
 
 #endif /* INC_TASK_H_ */
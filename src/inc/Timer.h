@@ -0,0 +1,83 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Software timers. Active timers are kept in a delta list driven by the kernel
+  tick, and their callbacks run one after the other in the timer daemon task,
+  so periodic or one-shot actions need no task (nor stack) of their own.
+*/
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "Tasks.h"
+
+struct OS_Timer;
+
+/** Function called by the timer daemon task when a timer expires */
+typedef void (*OS_TimerCallback)(struct OS_Timer* timer);
+
+/** Enum for timer modes */
+typedef enum {
+    OS_TIMER_ONE_SHOT,             // Expires once, then stays inactive until started again
+    OS_TIMER_AUTO_RELOAD           // Re-armed with its period at every expiry
+} OS_TimerMode;
+
+/** Enum for timer states */
+typedef enum {
+    OS_TIMER_OK,                   // Service done
+    OS_TIMER_ERROR,                // Invalid timer, callback or period
+    OS_TIMER_BLOCKED               // Internal: the daemon blocked waiting for an expiry
+} OS_TimerState;
+
+/** Software timer */
+typedef struct OS_Timer {
+    OS_ListNode link;              // Link in the active timer list (Value holds the delta ticks)
+    OS_ListNode expiredLink;       // Link in the list of expired timers waiting for their callback
+    OS_TimerCallback callback;     // Function called at expiry (in the timer daemon task)
+    void* argument;                // Application data, free for the callback to use
+    uint32_t period;               // Ticks from start to expiry, and between reloads
+    OS_TimerMode mode;             // One-shot or auto-reload
+} OS_Timer;
+
+/** Commands of the timer service */
+typedef enum {
+    OS_TIMER_CMD_START,            // Arm an inactive timer
+    OS_TIMER_CMD_RESET,            // Re-arm a timer, counting its period from now
+    OS_TIMER_CMD_STOP,             // Disarm a timer and drop its pending callback
+    OS_TIMER_CMD_CHANGE_PERIOD,    // Set a new period and re-arm the timer
+    OS_TIMER_CMD_TAKE              // Internal: the daemon takes the next expired timer
+} OS_TimerCommand;
+
+/** Arguments of the timer service, passed by address in R0 */
+typedef struct {
+    OS_Timer* timer;               // Timer the command applies to, or the expired timer taken
+    OS_TCB* task;                  // Calling task
+    uint32_t period;               // New period (OS_TIMER_CMD_CHANGE_PERIOD)
+    OS_TimerCommand command;       // Command to apply
+    OS_TimerState state;           // Result of the service
+} OS_TimerRequest;
+
+/* Function prototypes */
+OS_TimerState OS_TimerCreate(OS_Timer* timer, OS_TimerCallback callback, void* argument, uint32_t period, OS_TimerMode mode);
+OS_TimerState OS_TimerStart(OS_Timer* timer);
+OS_TimerState OS_TimerReset(OS_Timer* timer);
+OS_TimerState OS_TimerStop(OS_Timer* timer);
+OS_TimerState OS_TimerChangePeriod(OS_Timer* timer, uint32_t period);
+OS_TimerState OS_TimerStartFromISR(OS_Timer* timer);
+OS_TimerState OS_TimerResetFromISR(OS_Timer* timer);
+OS_TimerState OS_TimerStopFromISR(OS_Timer* timer);
+uint8_t OS_TimerIsActive(OS_Timer* timer);
+
+/* Kernel side of the service, called from the SVC handler and the tick */
+OS_ErrorStatus OS_TimerInit(void);
+uint8_t OS_TimerService(OS_TimerRequest* request);
+void OS_TimerTick(void);
+uint32_t OS_TimerGetExpectedIdleTicks(void);
+void OS_TimerStepTickCount(uint32_t ticks);
+
+#endif // TIMER_H
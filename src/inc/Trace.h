@@ -0,0 +1,124 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Scheduler event trace. With OS_TRACE_ENABLED the kernel logs compact time
+  stamped records (context switches, ready/block, service calls, contention,
+  interrupts) into a RAM ring buffer. OS_TraceData is self-describing: a raw
+  memory dump of it (or of the whole RAM) is turned into Chrome trace /
+  Perfetto JSON on the host by tools/TraceDecode.py.
+*/
+#ifndef INC_TRACE_H_
+#define INC_TRACE_H_
+
+#include <stdint.h>
+#include "Config.h"
+#include "Tasks.h"
+#include <Port.h>  // Angle brackets: the port include path selects the Port.h
+
+/** Recorded events, the values are part of the dump format */
+typedef enum {
+    OS_TRACE_SWITCH,               // Task switched in, Data = id of the task switched out
+    OS_TRACE_READY,                // Task made ready
+    OS_TRACE_BLOCK,                // Task removed from the ready lists (delay, wait, suspend)
+    OS_TRACE_SVC,                  // Service call by the task, Data = OS_SvcID
+    OS_TRACE_TICK,                 // SysTick, Task = running task
+    OS_TRACE_MUTEX_CONTENDED,      // Task blocked on a mutex, Data = id of the owner
+    OS_TRACE_SEMAPHORE_CONTENDED,  // Task blocked on a semaphore, Data = id of the owner or OS_TRACE_NO_TASK
+    OS_TRACE_ISR_ENTER,            // Interrupt handler entry, Data = IRQ number
+    OS_TRACE_ISR_EXIT              // Interrupt handler exit, Data = IRQ number
+} OS_TraceEvent;
+
+#if OS_TRACE_ENABLED
+
+#define OS_TRACE_MAGIC             0x45435254   // "TRCE" in a little-endian dump
+#define OS_TRACE_VERSION           1
+#define OS_TRACE_MAX_TASKS         32           // Task names kept in the dump
+#define OS_TRACE_NAME_LENGTH       16           // Bytes per task name, NUL padded
+#define OS_TRACE_NO_TASK           0xFF         // Task id of the records without a task
+
+#if (OS_TRACE_BUFFER_SIZE & (OS_TRACE_BUFFER_SIZE - 1)) != 0
+#error "OS_TRACE_BUFFER_SIZE must be a power of two"
+#endif
+
+/** One trace record, 8 bytes */
+typedef struct {
+    uint32_t Timestamp;            // Cycle counter (OS_GET_CYCLE_COUNT)
+    uint8_t Event;                 // OS_TraceEvent
+    uint8_t Task;                  // Task id (creation order), OS_TRACE_NO_TASK if none
+    uint16_t Data;                 // Event specific value
+} OS_TraceRecord;
+
+/** Trace buffer, dumped as is: header, task names, then the ring of records */
+typedef struct {
+    uint32_t Magic;                // OS_TRACE_MAGIC, locates the buffer in a memory dump
+    uint16_t Version;              // OS_TRACE_VERSION
+    uint8_t MaxTasks;              // OS_TRACE_MAX_TASKS
+    uint8_t NameLength;            // OS_TRACE_NAME_LENGTH
+    uint32_t Capacity;             // OS_TRACE_BUFFER_SIZE
+    uint32_t Frequency;            // Time stamp frequency in Hz
+    volatile uint32_t Written;     // Records written so far, the ring holds the last Capacity ones
+    char TaskNames[OS_TRACE_MAX_TASKS][OS_TRACE_NAME_LENGTH];
+    OS_TraceRecord Records[OS_TRACE_BUFFER_SIZE];
+} OS_Trace;
+
+extern OS_Trace OS_TraceData;
+
+/**
+ * @brief Id of a task in the records, OS_TRACE_NO_TASK for NULL.
+ */
+#define OS_TRACE_TASK_ID(Task)          (((Task) != NULL) ? (Task)->TraceId : OS_TRACE_NO_TASK)
+
+/* Function prototypes */
+void OS_TraceInit(void);
+void OS_TraceTaskCreated(OS_TCB* Task);
+
+/**
+ * @brief Appends a record, callable from any context.
+ *
+ * The slot is reserved with LDREX/STREX so that a nested interrupt never
+ * shares it; no interrupt is masked.
+ *
+ * @param Event OS_TraceEvent recorded.
+ * @param Task Task the event refers to, may be NULL.
+ * @param Data Event specific value.
+ */
+static inline void OS_TraceRecordEvent(uint8_t Event, const OS_TCB* Task, uint16_t Data) {
+    OS_TraceRecord* Record;
+    uint32_t Index;
+
+    do {
+        Index = OS_LOAD_EXCLUSIVE(&OS_TraceData.Written);
+    } while (OS_STORE_EXCLUSIVE(Index + 1, &OS_TraceData.Written));
+
+    Record = &OS_TraceData.Records[Index & (OS_TRACE_BUFFER_SIZE - 1)];
+    Record->Timestamp = OS_GET_CYCLE_COUNT();
+    Record->Event = Event;
+    Record->Task = OS_TRACE_TASK_ID(Task);
+    Record->Data = Data;
+}
+
+/**
+ * @brief Records a kernel event, compiled out when OS_TRACE_ENABLED is 0.
+ */
+#define OS_TRACE(Event, Task, Data)     OS_TraceRecordEvent((Event), (Task), (uint16_t)(Data))
+/**
+ * @brief Brackets an interrupt handler of the application in the trace.
+ */
+#define OS_TRACE_ISR_ENTER(Irq)         OS_TRACE(OS_TRACE_ISR_ENTER, OS_GetCurrentTask(), (Irq))
+#define OS_TRACE_ISR_EXIT(Irq)          OS_TRACE(OS_TRACE_ISR_EXIT, OS_GetCurrentTask(), (Irq))
+
+#else
+
+#define OS_TRACE(Event, Task, Data)
+#define OS_TRACE_TASK_ID(Task)          0
+#define OS_TRACE_ISR_ENTER(Irq)
+#define OS_TRACE_ISR_EXIT(Irq)
+
+#endif
+
+#endif /* INC_TRACE_H_ */
@@ -0,0 +1,445 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Implements the host (POSIX/Linux) simulation port. Every task runs on its
+  own ucontext, SIGALRM from a POSIX interval timer plays the SysTick, and
+  service calls and PendSV are emulated with the tick signal masked, which
+  mirrors the exception priorities of the Cortex-M3 port.
+  With OS_NUM_CORES > 1 every core is a thread switching in the task contexts
+  selected for it, so a task resumes on whichever core it was moved to.
+  SIGUSR1 sent to a core thread plays the inter-processor interrupt, and every
+  kernel entry holds a spin lock, handed over with the context switch to the
+  task switched in.
+*/
+#include <Config.h>
+#include <Port.h>
+#include <stdint.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include "Tasks.h"
+
+/* Size of the simulated RAM holding the stacks carved by MemManag.c */
+#define OS_SIM_RAM_SIZE           (64 * 1024)
+/* Maximum number of tasks owning a host context */
+#define OS_SIM_MAX_TASKS          100
+/* Host stack of each task, large enough for libc calls and signal frames */
+#define OS_SIM_TASK_STACK_SIZE    (64 * 1024)
+
+#define OS_SIM_STRINGIFY(x)       #x
+#define OS_SIM_TO_STRING(x)       OS_SIM_STRINGIFY(x)
+
+/* Simulated RAM, its end plays the _estack symbol of the target linker script */
+uint32_t OS_SimRam[OS_SIM_RAM_SIZE / 4];
+__asm__(".globl _estack\n\t.set _estack, OS_SimRam + " OS_SIM_TO_STRING(OS_SIM_RAM_SIZE));
+
+/* Host contexts and stacks, handed out on the first switch of each task */
+static ucontext_t SimContexts[OS_SIM_MAX_TASKS];
+static uint8_t SimStacks[OS_SIM_MAX_TASKS][OS_SIM_TASK_STACK_SIZE];
+static uint8_t SimNoOfContexts;
+
+volatile sig_atomic_t OS_SimPendSVPending[OS_NUM_CORES];
+/* Emulated exclusive monitor, set by OS_LOAD_EXCLUSIVE */
+volatile sig_atomic_t OS_SimExclusive;
+
+#if OS_NUM_CORES > 1
+#define OS_SIM_NO_CORE            0xFF
+
+/* Simulated cores, core 0 is the thread that called OS_StartOS */
+static pthread_t SimCoreThreads[OS_NUM_CORES];
+static volatile uint8_t SimCoresStarted;
+static __thread volatile uint8_t SimCoreId;
+
+/* Kernel spin lock, taken again without waiting by the core holding it */
+static volatile uint8_t SimLock;
+static volatile uint8_t SimLockOwner = OS_SIM_NO_CORE;
+static uint32_t SimLockDepth;
+
+/* Emulated global exclusive monitor: a store-exclusive succeeds if the generation
+ * seen by the load-exclusive of its core did not move in between */
+static volatile uint32_t SimMonitorGeneration;
+static volatile uint32_t SimMonitor[OS_NUM_CORES];
+static volatile uint8_t SimMonitorArmed[OS_NUM_CORES];
+#endif
+
+uint8_t SystickLed;
+
+/* Fills the set of signals playing the kernel interrupts: the tick and the inter-processor interrupt */
+static void OS_SimInterruptSet(sigset_t* Set) {
+    sigemptyset(Set);
+    sigaddset(Set, SIGALRM);
+#if OS_NUM_CORES > 1
+    sigaddset(Set, SIGUSR1);
+#endif
+}
+
+#if OS_NUM_CORES > 1
+/* Returns the core of the calling thread
+ * Never inlined: a task context switched out on one thread may resume on another,
+ * so the thread local variable has to be read again at every call.
+ */
+__attribute__((noinline)) uint8_t OS_SimCoreId(void) {
+    return SimCoreId;
+}
+
+/* Takes the kernel spin lock, called with the interrupt signals of the core masked */
+static void OS_SimLock(void) {
+    uint8_t Core = OS_SimCoreId();
+
+    if (SimLockOwner == Core) {
+        SimLockDepth++;
+        return;
+    }
+    while (__atomic_exchange_n(&SimLock, 1, __ATOMIC_ACQUIRE)) {
+        sched_yield();           // The holder may be waiting for the host CPU
+    }
+    SimLockOwner = Core;
+    SimLockDepth = 1;
+}
+
+/* Releases one level of the kernel spin lock */
+static void OS_SimUnlock(void) {
+    if (--SimLockDepth == 0) {
+        SimLockOwner = OS_SIM_NO_CORE;
+        __atomic_store_n(&SimLock, 0, __ATOMIC_RELEASE);
+    }
+}
+#endif
+
+/* Entry of an emulated exception: the exclusive monitors are cleared and the kernel is taken */
+static void OS_SimKernelEnter(void) {
+#if OS_NUM_CORES > 1
+    OS_SimLock();
+    SimMonitorGeneration++;
+#else
+    OS_SimExclusive = 0;
+#endif
+}
+
+/* Return of an emulated exception */
+static void OS_SimKernelExit(void) {
+#if OS_NUM_CORES > 1
+    OS_SimUnlock();
+#endif
+}
+
+/* First code run by a task context: ends the switch that started it like an exception return */
+static void OS_SimTaskStart(void) {
+    OS_TCB* Task = OS_ControlBlock.Cores[OS_CORE_ID()].CurrentTask;
+    sigset_t Interrupts;
+
+    OS_SimKernelExit();
+    OS_SimInterruptSet(&Interrupts);
+    sigprocmask(SIG_UNBLOCK, &Interrupts, NULL);
+
+    Task->func();
+}
+
+/* Returns the saved context of a task
+ * CurrentPSP points to the ucontext once the task owns one, before that it still
+ * points to the frame built by OS_CreateStack inside the simulated RAM.
+ * A task that never ran gets a fresh context starting at its function when it is
+ * switched in (NewStack), or an empty save area when it is switched out (the idle
+ * task started by OS_StartOS on the process stack).
+ */
+static ucontext_t* OS_SimContextOf(OS_TCB* Task, uint8_t NewStack) {
+    uintptr_t PSP = (uintptr_t)Task->CurrentPSP;
+    ucontext_t* Context;
+
+    if ((PSP < (uintptr_t)OS_SimRam) || (PSP > (uintptr_t)OS_SimRam + OS_SIM_RAM_SIZE)) {
+        return (ucontext_t*)Task->CurrentPSP;
+    }
+
+    if (SimNoOfContexts >= OS_SIM_MAX_TASKS) {
+        while (1) {}             /* Same behavior as a fault handler on target */
+    }
+
+    Context = &SimContexts[SimNoOfContexts];
+    if (NewStack) {
+        getcontext(Context);
+        Context->uc_stack.ss_sp = SimStacks[SimNoOfContexts];
+        Context->uc_stack.ss_size = OS_SIM_TASK_STACK_SIZE;
+        Context->uc_link = NULL;
+        OS_SimInterruptSet(&Context->uc_sigmask);   /* Unmasked by OS_SimTaskStart */
+        makecontext(Context, OS_SimTaskStart, 0);
+    }
+    SimNoOfContexts++;
+
+    Task->CurrentPSP = (uint32_t*)Context;
+    return Context;
+}
+
+/* Emulated PendSV: switches the core from CurrentTask to NextTask
+ * Runs with SIGALRM masked, at the end of a service call or of a tick.
+ * With several cores the kernel lock is held through the switch: the context
+ * switched in releases it, so no other core can resume the task switched out
+ * before its context is saved.
+ */
+static void OS_SimPendSV(void) {
+    OS_Core* Core = &OS_ControlBlock.Cores[OS_CORE_ID()];
+    OS_TCB* PreviousTask;
+
+    if (!OS_SimPendSVPending[OS_CORE_ID()])
+        return;
+    OS_SimPendSVPending[OS_CORE_ID()] = 0;
+
+    if (Core->NextTask == NULL)
+        return;
+
+    PreviousTask = Core->CurrentTask;
+    Core->CurrentTask = Core->NextTask;
+    Core->NextTask = NULL;
+
+    if (PreviousTask != Core->CurrentTask) {
+#if OS_SWITCH_HOOK_ENABLED
+        OS_TaskSwitched(PreviousTask, Core->CurrentTask);
+#endif
+        ucontext_t* Save = OS_SimContextOf(PreviousTask, 0);
+#if OS_NUM_CORES > 1
+        uint32_t Depth = SimLockDepth;
+#endif
+        swapcontext(Save, OS_SimContextOf(Core->CurrentTask, 1));
+#if OS_NUM_CORES > 1
+        // Resumed, maybe on another core: the lock held by the switching core is ours
+        SimLockDepth = Depth;
+#endif
+    }
+}
+
+/* SysTick Handler for OS tick update and context switching */
+void SysTick_Handler(void) {
+#if OS_PROFILING_ENABLED
+	uint32_t StartCycles = OS_GET_CYCLE_COUNT();
+#endif
+	uint32_t Interrupts;
+	SystickLed ^= 1;       // Toggle the SysTick LED to visually verify operation
+	/* Interrupts calling the FromISR services must not see the kernel state half updated */
+	Interrupts = OS_EnterCriticalFromISR();
+	OS_UpdateNoOfTicks();           // Update the OS tick count
+	OS_ExitCriticalFromISR(Interrupts);
+#if OS_TICK_HOOK_ENABLED
+	if (SysTickHook != NULL) {
+	    SysTickHook();           // Call the SysTick hook, if registered
+	}
+#endif
+	Interrupts = OS_EnterCriticalFromISR();
+	OS_DecideNext();                // Determine the next task to run
+#if OS_PREEMPTION_ENABLED
+	if (OS_SwitchRequired()) {
+	    OS_TRIGGER_PENDSV();   // Trigger PendSV only if preemption is enabled and the task changes
+	}
+#endif
+	OS_ExitCriticalFromISR(Interrupts);
+#if OS_PROFILING_ENABLED
+	OS_ProfileData.TickLastCycles = OS_GET_CYCLE_COUNT() - StartCycles;
+	if (OS_ProfileData.TickLastCycles > OS_ProfileData.TickMaxCycles) {
+		OS_ProfileData.TickMaxCycles = OS_ProfileData.TickLastCycles;
+	}
+#endif
+}
+
+/* SIGALRM handler: the tick followed by the tail-chained PendSV */
+static void OS_SimTickSignal(int Signal) {
+    (void)Signal;
+    OS_SimKernelEnter();
+    SysTick_Handler();
+    OS_SimPendSV();
+    OS_SimKernelExit();
+}
+
+#if OS_NUM_CORES > 1
+/* SIGUSR1 handler: the inter-processor interrupt, the core takes its scheduling decision again */
+static void OS_SimCoreSignal(int Signal) {
+    uint32_t Interrupts;
+
+    (void)Signal;
+    OS_SimKernelEnter();
+    Interrupts = OS_EnterCriticalFromISR();
+    OS_RescheduleFromISR();
+    OS_ExitCriticalFromISR(Interrupts);
+    OS_SimPendSV();
+    OS_SimKernelExit();
+}
+
+/* Interrupts a core to make it take its scheduling decision again */
+void OS_SimSignalCore(uint8_t Core) {
+    if (__atomic_load_n(&SimCoresStarted, __ATOMIC_ACQUIRE)) {
+        pthread_kill(SimCoreThreads[Core], SIGUSR1);
+    }
+}
+
+/* Body of the threads of the cores 1 to OS_NUM_CORES - 1 */
+static void* OS_SimCoreMain(void* Arg) {
+    sigset_t Interrupts;
+
+    SimCoreId = (uint8_t)(uintptr_t)Arg;
+    OS_SimInterruptSet(&Interrupts);
+    sigprocmask(SIG_UNBLOCK, &Interrupts, NULL);
+
+    // Like core 0 in OS_StartOS, the core runs its idle task on the thread stack
+    OS_ControlBlock.Cores[SimCoreId].CurrentTask->func();
+    return NULL;
+}
+
+/* Starts the other cores, called by OS_StartOS on core 0 */
+void OS_StartCores(void) {
+    sigset_t Interrupts;
+    sigset_t PreviousMask;
+
+    // The threads inherit the masked interrupts until they know their core
+    OS_SimInterruptSet(&Interrupts);
+    sigprocmask(SIG_BLOCK, &Interrupts, &PreviousMask);
+
+    SimCoreThreads[0] = pthread_self();
+    for (uint8_t Core = 1; Core < OS_NUM_CORES; Core++) {
+        pthread_create(&SimCoreThreads[Core], NULL, OS_SimCoreMain, (void*)(uintptr_t)Core);
+    }
+    __atomic_store_n(&SimCoresStarted, 1, __ATOMIC_RELEASE);
+
+    sigprocmask(SIG_SETMASK, &PreviousMask, NULL);
+}
+#endif
+
+/* Emulated SVC exception
+ * The tick is masked while the service runs, like SysTick cannot preempt SVC on target.
+ */
+void OS_SimServiceCall(uint8_t SVC_ID, void* Arg) {
+    OS_SimSvcFrame Frame;
+    sigset_t Interrupts;
+    sigset_t PreviousMask;
+
+    Frame.Arg = (uintptr_t)Arg;
+    Frame.Id = SVC_ID;
+
+    OS_SimInterruptSet(&Interrupts);
+    sigprocmask(SIG_BLOCK, &Interrupts, &PreviousMask);
+    OS_SimKernelEnter();
+
+    OS_SvcServices((uint32_t*)&Frame);
+    OS_SimPendSV();
+
+    OS_SimKernelExit();
+    sigprocmask(SIG_SETMASK, &PreviousMask, NULL);
+}
+
+/* Emulated PRIMASK: blocks the tick signal and returns 1 if it was already blocked
+ * With several cores the kernel spin lock is taken as well.
+ */
+uint32_t OS_SimMaskTick(void) {
+    sigset_t Interrupts;
+    sigset_t PreviousMask;
+
+    OS_SimInterruptSet(&Interrupts);
+    sigprocmask(SIG_BLOCK, &Interrupts, &PreviousMask);
+#if OS_NUM_CORES > 1
+    OS_SimLock();
+#endif
+
+    return (uint32_t)sigismember(&PreviousMask, SIGALRM);
+}
+
+/* Unblocks the tick signal unless it was blocked before the matching OS_SimMaskTick */
+void OS_SimRestoreTick(uint32_t State) {
+    sigset_t Interrupts;
+
+#if OS_NUM_CORES > 1
+    OS_SimUnlock();
+#endif
+    if (State)
+        return;
+
+    OS_SimInterruptSet(&Interrupts);
+    sigprocmask(SIG_UNBLOCK, &Interrupts, NULL);
+}
+
+/* Emulated STREX: stores only if no signal or service call cleared the monitor since the load
+ * Returns 0 on success like the instruction.
+ */
+uint32_t OS_SimStoreExclusive(volatile void* Address, uintptr_t Value, size_t Size) {
+    uint32_t State = OS_SimMaskTick();
+    uint32_t Failed = 1;
+#if OS_NUM_CORES > 1
+    uint8_t Core = OS_SimCoreId();
+    uint8_t Exclusive = SimMonitorArmed[Core] && (SimMonitor[Core] == SimMonitorGeneration);
+#else
+    uint8_t Exclusive = OS_SimExclusive;
+#endif
+
+    if (Exclusive) {
+        if (Size == sizeof(uint32_t))
+            *(volatile uint32_t*)Address = (uint32_t)Value;
+        else
+            *(volatile uintptr_t*)Address = Value;
+        Failed = 0;
+    }
+#if OS_NUM_CORES > 1
+    // The store clears the monitors of the other cores
+    SimMonitorGeneration += Exclusive;
+    SimMonitorArmed[Core] = 0;
+#else
+    OS_SimExclusive = 0;
+#endif
+
+    OS_SimRestoreTick(State);
+    return Failed;
+}
+
+#if OS_NUM_CORES > 1
+/* Emulated LDREX of the calling core, before its load */
+void OS_SimLoadExclusive(void) {
+    uint8_t Core = OS_SimCoreId();
+
+    SimMonitor[Core] = __atomic_load_n(&SimMonitorGeneration, __ATOMIC_ACQUIRE);
+    SimMonitorArmed[Core] = 1;
+}
+
+/* Emulated CLREX of the calling core */
+void OS_SimClearExclusive(void) {
+    SimMonitorArmed[OS_SimCoreId()] = 0;
+}
+#endif
+
+/* Free running counter: nanoseconds of the monotonic clock */
+uint32_t OS_SimGetCycleCount(void) {
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint32_t)(((uint64_t)Now.tv_sec * 1000000000ULL) + (uint64_t)Now.tv_nsec);
+}
+
+/* OS hardware initialization function */
+void OS_HwInit() {
+    struct sigaction Action;
+
+    /* SIGALRM plays the SysTick exception, the kernel interrupts do not nest */
+    Action.sa_handler = OS_SimTickSignal;
+    OS_SimInterruptSet(&Action.sa_mask);
+    Action.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &Action, NULL);
+#if OS_NUM_CORES > 1
+    /* SIGUSR1 plays the inter-processor interrupt */
+    Action.sa_handler = OS_SimCoreSignal;
+    sigaction(SIGUSR1, &Action, NULL);
+#endif
+
+#if OS_PROFILING_ENABLED
+    OS_CYCLE_COUNTER_INIT();
+#endif
+}
+
+/* Start OS timer for scheduling */
+void OS_StartTimer() {
+    struct itimerval Timer;
+
+    Timer.it_interval.tv_sec = OS_TICK_TIME_IN_MS / 1000;
+    Timer.it_interval.tv_usec = (OS_TICK_TIME_IN_MS % 1000) * 1000;
+    Timer.it_value = Timer.it_interval;
+    setitimer(ITIMER_REAL, &Timer, NULL);
+}
@@ -0,0 +1,130 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Host (POSIX/Linux) simulation port. Tasks run on ucontext contexts, a
+  POSIX interval timer plays the SysTick and the PendSV/SVC exceptions are
+  emulated with SIGALRM masking, so the unmodified kernel runs as a process.
+  With OS_NUM_CORES > 1 every core is a thread, SIGUSR1 plays the
+  inter-processor interrupt and a spin lock serializes the kernel sections.
+*/
+#ifndef INC_POSIX_OS_PORTING_H_
+#define INC_POSIX_OS_PORTING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <signal.h>
+#include <unistd.h>
+#include "Config.h"
+
+#if OS_TICKLESS_IDLE_ENABLED
+#error "Tickless idle is not supported by the POSIX simulation port"
+#endif
+
+/* Identifies the port for portable applications */
+#define OS_PORT_POSIX                 1
+
+/** Emulated exception frame of a service call */
+typedef struct {
+    uintptr_t Arg;                 // Service argument (R0 on target)
+    uint8_t Id;                    // Service number (SVC immediate on target)
+} OS_SimSvcFrame;
+
+/**
+ * @brief Stack pointer handling has no meaning on the host, every task owns a ucontext.
+ */
+#define OS_SET_PSP(add)               ((void)(add))
+#define OS_GET_PSP(add)               ((void)(add))
+#define OS_SWITCH_TO_PSP()
+#define OS_SWITCH_TO_MSP()
+#define OS_SWITCH_TO_PRIVELEGE()
+#define OS_SWITCH_TO_NOT_PRIVELEGE()
+/**
+ * @brief Macro to pend the emulated PendSV, the switch happens when the service call or tick returns.
+ */
+#define OS_TRIGGER_PENDSV()           OS_SimPendSVPending[OS_CORE_ID()] = 1;
+/**
+ * @brief Macro to request a kernel service (emulated SVC exception).
+ */
+#define OS_REQUEST_SERVICE(SVC_ID)    OS_SimServiceCall((SVC_ID), NULL);
+/**
+ * @brief Macro to request a kernel service passing the target task.
+ */
+#define OS_REQUEST_SERVICE_ARG(SVC_ID, Arg)  OS_SimServiceCall((SVC_ID), (void*)(Arg));
+/**
+ * @brief Macros to get the SVC number and argument from the emulated frame.
+ */
+#define OS_SVC_GET_ID(Stack_Pointer)  (((OS_SimSvcFrame*)(Stack_Pointer))->Id)
+#define OS_SVC_GET_ARG(Stack_Pointer) ((void*)((OS_SimSvcFrame*)(Stack_Pointer))->Arg)
+/**
+ * @brief Macro to sleep until the next signal (tick).
+ */
+#define OS_WAIT_FOR_EVENT()           pause()
+/**
+ * @brief Macro to count the leading zero bits of a 32-bit word.
+ */
+#define OS_COUNT_LEADING_ZEROS(x)     ((uint32_t)__builtin_clz(x))
+/**
+ * @brief Macros for the free running counter, nanoseconds of CLOCK_MONOTONIC on the host.
+ */
+#define OS_CYCLE_COUNTER_INIT()
+#define OS_GET_CYCLE_COUNT()          OS_SimGetCycleCount()
+#define OS_CYCLE_COUNTER_FREQ_IN_HZ   1000000000
+/**
+ * @brief Macros emulating the LDREX/STREX exclusive monitor, the tick signal clears it like an exception does.
+ *        With several cores any kernel entry or successful store of any core clears the monitors of all.
+ */
+#if OS_NUM_CORES > 1
+#define OS_LOAD_EXCLUSIVE(Address)          (OS_SimLoadExclusive(), *(Address))
+#define OS_CLEAR_EXCLUSIVE()                OS_SimClearExclusive()
+#else
+#define OS_LOAD_EXCLUSIVE(Address)          (OS_SimExclusive = 1, *(Address))
+#define OS_CLEAR_EXCLUSIVE()                (OS_SimExclusive = 0)
+#endif
+#define OS_STORE_EXCLUSIVE(Value, Address)  OS_SimStoreExclusive((Address), (uintptr_t)(Value), sizeof(*(Address)))
+/**
+ * @brief Orders the memory accesses before it against those after it, for data shared without a lock.
+ */
+#define OS_MEMORY_BARRIER()                 __atomic_thread_fence(__ATOMIC_SEQ_CST)
+/**
+ * @brief Macros to mask the tick signal around kernel updates, nesting safe (0 is unmasked).
+ *        With several cores they also hold the kernel spin lock.
+ */
+#define OS_MASK_INTERRUPTS()                OS_SimMaskTick()
+#define OS_RESTORE_INTERRUPTS(State)        OS_SimRestoreTick(State)
+/**
+ * @brief Host tasks may block the tick signal themselves, critical sections need no service call.
+ */
+#define OS_TASKS_CAN_MASK_INTERRUPTS        1
+/**
+ * @brief Index of the core (thread) running the caller, and the inter-processor interrupt.
+ */
+#if OS_NUM_CORES > 1
+#define OS_CORE_ID()                        OS_SimCoreId()
+#define OS_SIGNAL_CORE(Core)                OS_SimSignalCore(Core)
+#else
+#define OS_CORE_ID()                        0U
+#endif
+
+extern volatile sig_atomic_t OS_SimPendSVPending[OS_NUM_CORES];
+extern volatile sig_atomic_t OS_SimExclusive;
+
+void OS_SimServiceCall(uint8_t SVC_ID, void* Arg);
+uint32_t OS_SimGetCycleCount(void);
+uint32_t OS_SimMaskTick(void);
+void OS_SimRestoreTick(uint32_t State);
+uint32_t OS_SimStoreExclusive(volatile void* Address, uintptr_t Value, size_t Size);
+#if OS_NUM_CORES > 1
+uint8_t OS_SimCoreId(void);
+void OS_SimSignalCore(uint8_t Core);
+void OS_SimLoadExclusive(void);
+void OS_SimClearExclusive(void);
+void OS_StartCores(void);
+#endif
+void OS_HwInit();
+void OS_StartTimer();
+#endif /* INC_POSIX_OS_PORTING_H_ */
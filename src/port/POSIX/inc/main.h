@@ -0,0 +1,20 @@
+/*
+  Project   : RA3 RTOS
+  Author    : Ali Yasser
+  Date      : October 17, 2026
+  Version   : 1.0
+  Contact   : k4.k4.3li@gmail.com
+
+  Description:
+  Stand-in for the STM32CubeMX main.h used by the examples, so they build
+  unmodified against the POSIX simulation port.
+*/
+#ifndef INC_POSIX_MAIN_H_
+#define INC_POSIX_MAIN_H_
+
+/* Board bring-up has nothing to do on the host */
+static inline void HAL_Init(void) {}
+static inline void SystemClock_Config(void) {}
+static inline void MX_GPIO_Init(void) {}
+
+#endif /* INC_POSIX_MAIN_H_ */
@@ -0,0 +1,265 @@
+/*
+  Withdrawal of blocked tasks.
+
+  A task blocked on each kind of synchronization object is terminated, then
+  the object is used again: the terminated task must not be completed or
+  woken, and the object must be left as if the task had never waited. The
+  last case terminates a third waiter of a mutex caught in a deadlock cycle,
+  the inheritance walk has to stop.
+
+  One line per case, then PASS with exit code 0, or FAIL with exit code 1.
+  Host: make -C src/port/POSIX test
+*/
+#include "main.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Tasks.h"
+#include "Mutex.h"
+#include "Semaphore.h"
+#include "Queue.h"
+#include "EventGroup.h"
+#include "StreamBuffer.h"
+
+#define TEST_DRIVER_PRIORITY      1
+#define TEST_WAITER_PRIORITY      3
+#define TEST_OWNER_PRIORITY       5
+#define TEST_SETTLE               3        // Ticks the other tasks get to block
+
+OS_TCB Driver, Owner, DeadlockOwner, CycleOwner;
+OS_TCB NotifyWaiter, SignalWaiter, ResourceWaiter, MutexWaiter, QueueReceiver, QueueSender;
+OS_TCB EventWaiter, StreamReader, CycleWaiter;
+OS_Semaphore Signal, Resource;
+OS_Mutex Lock, Lock2, Lock3;
+OS_Queue Queue;
+void* QueueStorage[1];
+OS_EventGroup Events;
+OS_StreamBuffer Stream;
+uint8_t StreamStorage[16];
+
+volatile uint8_t Woken;                        // A terminated waiter ran past its wait
+uint8_t Failures;
+
+static void check (const char* Case, uint8_t Ok){
+	printf("%-24s %s\n", Case, Ok ? "ok" : "FAILED");
+	if(!Ok)
+		Failures++;
+}
+
+/* Terminates the waiter once it blocked, and checks it is off every list */
+static uint8_t withdraw (OS_TCB* Task){
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	OS_TerminateTask(Task);
+	return (Task->WaitQueue == NULL) && (Task->WaitRequest == NULL) && (Task->WaitMutex == NULL);
+}
+
+void notifyWaiter (){
+	OS_NotifyWait(0, NULL, OS_WAIT_FOREVER);
+	Woken = 1;
+	OS_TerminateTask(&NotifyWaiter);
+}
+
+void signalWaiter (){
+	OS_AcquireSemaphore(&Signal, &SignalWaiter);
+	Woken = 1;
+	OS_TerminateTask(&SignalWaiter);
+}
+
+void resourceWaiter (){
+	OS_AcquireSemaphore(&Resource, &ResourceWaiter);
+	Woken = 1;
+	OS_TerminateTask(&ResourceWaiter);
+}
+
+void mutexWaiter (){
+	OS_AcquireMutex(&Lock, &MutexWaiter);
+	Woken = 1;
+	OS_TerminateTask(&MutexWaiter);
+}
+
+void queueReceiver (){
+	void* Message;
+
+	OS_QueueReceive(&Queue, &Message, OS_WAIT_FOREVER);
+	Woken = 1;
+	OS_TerminateTask(&QueueReceiver);
+}
+
+void queueSender (){
+	OS_QueueSend(&Queue, &QueueSender, OS_WAIT_FOREVER);
+	Woken = 1;
+	OS_TerminateTask(&QueueSender);
+}
+
+void eventWaiter (){
+	OS_WaitForEventBits(&Events, 0x1, 1, 1, OS_WAIT_FOREVER);
+	Woken = 1;
+	OS_TerminateTask(&EventWaiter);
+}
+
+void streamReader (){
+	uint8_t Data[8];
+
+	OS_StreamReceive(&Stream, Data, sizeof(Data), OS_WAIT_FOREVER);
+	Woken = 1;
+	OS_TerminateTask(&StreamReader);
+}
+
+void cycleWaiter (){
+	OS_AcquireMutex(&Lock2, &CycleWaiter);
+	Woken = 1;
+	OS_TerminateTask(&CycleWaiter);
+}
+
+/* Holds the semaphore unit and the mutex the waiters ask for, until notified */
+void owner (){
+	OS_AcquireSemaphore(&Resource, &Owner);
+	OS_AcquireMutex(&Lock, &Owner);
+	OS_NotifyWait(0, NULL, OS_WAIT_FOREVER);
+	OS_ReleaseMutex(&Lock);
+	OS_ReleaseSemaphore(&Resource);
+	OS_TerminateTask(&Owner);
+}
+
+/* Deadlock: DeadlockOwner holds Lock2 and waits for Lock3, CycleOwner holds Lock3 and waits for Lock2 */
+void deadlockOwner (){
+	OS_AcquireMutex(&Lock2, &DeadlockOwner);
+	OS_DelayTask(&DeadlockOwner, 1);
+	OS_AcquireMutex(&Lock3, &DeadlockOwner);
+	OS_TerminateTask(&DeadlockOwner);
+}
+
+void cycleOwner (){
+	OS_AcquireMutex(&Lock3, &CycleOwner);
+	OS_DelayTask(&CycleOwner, 2);
+	OS_AcquireMutex(&Lock2, &CycleOwner);
+	OS_TerminateTask(&CycleOwner);
+}
+
+void driver (){
+	void* Message = NULL;
+	uint8_t Data[4] = {0};
+	uint8_t Ok;
+
+	// Notification: a later notification stays pending for the next wait
+	OS_ActivateTask(&NotifyWaiter);
+	Ok = withdraw(&NotifyWaiter);
+	OS_Notify(&NotifyWaiter, 0x5, OS_NOTIFY_SET_BITS);
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	check("notify", Ok && (NotifyWaiter.NotifyState == OS_TASK_NOTIFY_PENDING));
+
+	// Signal semaphore: the unit the waiter took is given back
+	OS_ActivateTask(&SignalWaiter);
+	Ok = withdraw(&SignalWaiter) && (Signal.count == 0) && (Signal.waitingCount == 0);
+	OS_ReleaseSemaphore(&Signal);
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	check("semaphore signal", Ok && (Signal.count == 1));
+
+	// Semaphore and mutex held by Owner
+	OS_ActivateTask(&Owner);
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	OS_ActivateTask(&ResourceWaiter);
+	Ok = withdraw(&ResourceWaiter);
+	check("semaphore resource", Ok && (Resource.count == 0) && (Resource.waitingCount == 0));
+
+	OS_ActivateTask(&MutexWaiter);
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	Ok = (Owner.Priority == TEST_WAITER_PRIORITY) && withdraw(&MutexWaiter);
+	check("mutex", Ok && (Lock.waitingCount == 0) && (Owner.Priority == TEST_OWNER_PRIORITY));
+
+	OS_Notify(&Owner, 0, OS_NOTIFY_SET_BITS);
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	check("released", (Resource.count == 1) && !Lock.isLocked);
+
+	// Queue, empty then full
+	OS_ActivateTask(&QueueReceiver);
+	Ok = withdraw(&QueueReceiver);
+	check("queue receive", Ok && (OS_QueueSend(&Queue, &Driver, 0) == OS_QUEUE_OK) && (Queue.counter == 1));
+
+	OS_ActivateTask(&QueueSender);
+	Ok = withdraw(&QueueSender);
+	Ok = Ok && (OS_QueueReceive(&Queue, &Message, 0) == OS_QUEUE_OK) && (Message == &Driver);
+	check("queue send", Ok && (Queue.counter == 0));
+
+	// Event group: the bits are not consumed for the terminated waiter
+	OS_ActivateTask(&EventWaiter);
+	Ok = withdraw(&EventWaiter);
+	OS_SetEventBits(&Events, 0x1);
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	check("event group", Ok && (Events.bits == 0x1));
+
+	// Stream buffer: the bytes stay stored for the next reader
+	OS_ActivateTask(&StreamReader);
+	Ok = withdraw(&StreamReader);
+	OS_StreamSendFromISR(&Stream, Data, sizeof(Data));
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	check("stream buffer", Ok && (OS_StreamBytesAvailable(&Stream) == sizeof(Data)));
+
+	// Third waiter of a mutex in a deadlock cycle
+	OS_ActivateTask(&DeadlockOwner);
+	OS_ActivateTask(&CycleOwner);
+	OS_DelayTask(&Driver, TEST_SETTLE);
+	OS_ActivateTask(&CycleWaiter);
+	Ok = withdraw(&CycleWaiter);
+	check("mutex deadlock cycle", Ok && (Lock2.waitingCount == 1));
+
+	check("no waiter woken", !Woken);
+	puts(Failures ? "FAIL" : "PASS");
+	fflush(stdout);
+	exit(Failures ? 1 : 0);
+}
+
+static void create (OS_TCB* Task, void (*Func)(void), uint8_t Priority, const char* Name){
+	Task->func = Func;
+	Task->Priority = Priority;
+	strcpy(Task->TaskName, Name);
+	Task->StackSize = 1024;
+
+	if(OS_CreateTask(Task) != OS_OK)
+		exit(1);
+}
+
+int main(void)
+{
+  HAL_Init();
+
+  SystemClock_Config();
+
+  if(OS_Init() != OS_OK)
+	  exit(1);
+
+  OS_InitSemaphore(&Signal, 0);
+  OS_InitSemaphore(&Resource, 1);
+  OS_InitMutex(&Lock);
+  OS_InitMutex(&Lock2);
+  OS_InitMutex(&Lock3);
+  OS_InitQueue(&Queue, QueueStorage, 1, OS_WAIT_FIFO);
+  OS_InitEventGroup(&Events);
+  OS_InitStreamBuffer(&Stream, StreamStorage, sizeof(StreamStorage), 8);
+
+  create(&Driver, driver, TEST_DRIVER_PRIORITY, "Driver");
+  create(&Owner, owner, TEST_OWNER_PRIORITY, "Owner");
+  create(&DeadlockOwner, deadlockOwner, TEST_OWNER_PRIORITY, "DeadlockOwner");
+  create(&CycleOwner, cycleOwner, TEST_OWNER_PRIORITY + 1, "CycleOwner");
+  create(&NotifyWaiter, notifyWaiter, TEST_WAITER_PRIORITY, "NotifyWaiter");
+  create(&SignalWaiter, signalWaiter, TEST_WAITER_PRIORITY, "SignalWaiter");
+  create(&ResourceWaiter, resourceWaiter, TEST_WAITER_PRIORITY, "ResourceWaiter");
+  create(&MutexWaiter, mutexWaiter, TEST_WAITER_PRIORITY, "MutexWaiter");
+  create(&QueueReceiver, queueReceiver, TEST_WAITER_PRIORITY, "QueueReceiver");
+  create(&QueueSender, queueSender, TEST_WAITER_PRIORITY, "QueueSender");
+  create(&EventWaiter, eventWaiter, TEST_WAITER_PRIORITY, "EventWaiter");
+  create(&StreamReader, streamReader, TEST_WAITER_PRIORITY, "StreamReader");
+  create(&CycleWaiter, cycleWaiter, TEST_WAITER_PRIORITY, "CycleWaiter");
+
+  if(OS_ActivateTask(&Driver) != OS_OK)
+	  exit(1);
+
+  OS_StartOS();
+
+  while (1)
+  {
+
+  }
+}
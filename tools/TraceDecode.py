@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""
+RA3 RTOS - scheduler trace decoder
+
+Converts a memory dump holding OS_TraceData (OS_TRACE_ENABLED, see
+src/inc/Trace.h) into Chrome trace JSON, to be opened with chrome://tracing
+or https://ui.perfetto.dev. Each task is a thread whose slices are the
+periods it ran; ready/block, service calls and contention are instant
+events; interrupts bracketed with OS_TRACE_ISR_ENTER/EXIT are slices of an
+"Interrupts" thread. Every slice carries the latency from the moment the
+task was made ready until it was switched in, and the worst latency of each
+task is printed on stderr.
+
+Getting a dump:
+  gdb         dump binary value trace.bin OS_TraceData
+  OpenOCD     dump_image trace.bin <address of OS_TraceData> <sizeof(OS_TraceData)>
+  host port   fwrite(&OS_TraceData, sizeof(OS_TraceData), 1, File)
+A dump of the whole RAM works too: the buffer is found by its magic word.
+
+Usage: TraceDecode.py trace.bin [-o trace.json]
+"""
+import argparse
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x45435254
+TRACE_VERSION = 1
+HEADER = struct.Struct("<IHBBIII")      # Magic, Version, MaxTasks, NameLength, Capacity, Frequency, Written
+RECORD = struct.Struct("<IBBH")         # Timestamp, Event, Task, Data
+NO_TASK = 0xFF
+
+# OS_TraceEvent
+SWITCH, READY, BLOCK, SVC, TICK, MUTEX_CONTENDED, SEMAPHORE_CONTENDED, ISR_ENTER, ISR_EXIT = range(9)
+
+# OS_SvcID, in the order of src/inc/Tasks.h
+SVC_NAMES = [
+    "activate", "terminate", "waiting", "suspend", "acquire_mutex", "release_mutex",
+    "delay", "tickless_idle", "notify", "notify_wait", "queue_send", "queue_receive",
+    "acquire_semaphore", "release_semaphore", "event_wait", "event_set",
+    "enter_critical", "exit_critical", "runtime_stats", "delay_until", "timer",
+    "yield", "stream_receive",
+]
+
+PID = 1
+KERNEL_TID = 1000
+ISR_TID = 1001
+
+
+def find_trace(dump):
+    """Returns the header fields and the offset of the first valid trace buffer of the dump."""
+    offset = dump.find(struct.pack("<I", TRACE_MAGIC))
+    while offset >= 0:
+        if offset % 4 == 0 and offset + HEADER.size <= len(dump):
+            fields = HEADER.unpack_from(dump, offset)
+            magic, version, max_tasks, name_length, capacity, frequency, written = fields
+            size = HEADER.size + max_tasks * name_length + capacity * RECORD.size
+            if (version == TRACE_VERSION and capacity and not capacity & (capacity - 1)
+                    and frequency and offset + size <= len(dump)):
+                return fields, offset
+        offset = dump.find(struct.pack("<I", TRACE_MAGIC), offset + 1)
+    return None, -1
+
+
+def read_records(dump, offset, fields):
+    """Returns the task names and the records of the ring, oldest first, with unwrapped time stamps."""
+    _, _, max_tasks, name_length, capacity, frequency, written = fields
+    names_offset = offset + HEADER.size
+    records_offset = names_offset + max_tasks * name_length
+
+    names = {}
+    for task in range(max_tasks):
+        raw = dump[names_offset + task * name_length:names_offset + (task + 1) * name_length]
+        name = raw.split(b"\0", 1)[0].decode("ascii", "replace")
+        if name:
+            names[task] = name
+
+    count = min(written, capacity)
+    first = written - count
+    records = []
+    time = 0
+    previous = None
+    for index in range(first, written):
+        stamp, event, task, data = RECORD.unpack_from(dump, records_offset + (index % capacity) * RECORD.size)
+        if previous is not None:
+            # Signed delta: a nested interrupt may stamp its record before the one it preempted
+            delta = (stamp - previous) & 0xFFFFFFFF
+            time += delta - (1 << 32) if delta & 0x80000000 else delta
+        previous = stamp
+        records.append((time * 1e6 / frequency, event, task, data))
+    return names, records, written - count
+
+
+def task_name(names, task):
+    if task == NO_TASK:
+        return "none"
+    return names.get(task, "task%d" % task)
+
+
+def convert(names, records):
+    """Builds the Chrome trace events and the worst wake-up latency of each task (microseconds)."""
+    events = [{"name": "process_name", "ph": "M", "pid": PID, "args": {"name": "RA3 RTOS"}},
+              {"name": "thread_name", "ph": "M", "pid": PID, "tid": KERNEL_TID, "args": {"name": "Kernel"}},
+              {"name": "thread_name", "ph": "M", "pid": PID, "tid": ISR_TID, "args": {"name": "Interrupts"}}]
+    seen = set()
+    running = None               # (task, start, latency) of the slice in progress
+    ready_since = {}             # Time each ready task was made ready
+    worst = {}
+
+    def thread(task):
+        if task not in seen and task != NO_TASK:
+            seen.add(task)
+            events.append({"name": "thread_name", "ph": "M", "pid": PID, "tid": task,
+                           "args": {"name": task_name(names, task)}})
+        return task
+
+    def instant(name, tid, ts, args=None):
+        event = {"name": name, "ph": "i", "s": "t", "pid": PID, "tid": tid, "ts": ts}
+        if args:
+            event["args"] = args
+        events.append(event)
+
+    def close(end):
+        task, start, latency = running
+        args = {"wake_latency_us": round(latency, 3)} if latency is not None else {}
+        events.append({"name": task_name(names, task), "ph": "X", "pid": PID, "tid": thread(task),
+                       "ts": start, "dur": max(end - start, 0), "args": args})
+
+    for ts, event, task, data in records:
+        if event == SWITCH:
+            if running is not None:
+                close(ts)
+            latency = None
+            if task in ready_since:
+                latency = ts - ready_since.pop(task)
+                worst[task] = max(worst.get(task, 0), latency)
+            running = (task, ts, latency)
+        elif event == READY:
+            ready_since.setdefault(task, ts)
+            instant("ready", thread(task), ts)
+        elif event == BLOCK:
+            ready_since.pop(task, None)
+            instant("block", thread(task), ts)
+        elif event == SVC:
+            name = SVC_NAMES[data] if data < len(SVC_NAMES) else "svc%d" % data
+            instant("svc " + name, thread(task) if task != NO_TASK else KERNEL_TID, ts)
+        elif event == TICK:
+            instant("tick", KERNEL_TID, ts)
+        elif event in (MUTEX_CONTENDED, SEMAPHORE_CONTENDED):
+            kind = "mutex" if event == MUTEX_CONTENDED else "semaphore"
+            instant(kind + " contended", thread(task), ts, {"owner": task_name(names, data)})
+        elif event == ISR_ENTER:
+            events.append({"name": "IRQ %d" % data, "ph": "B", "pid": PID, "tid": ISR_TID, "ts": ts})
+        elif event == ISR_EXIT:
+            events.append({"name": "IRQ %d" % data, "ph": "E", "pid": PID, "tid": ISR_TID, "ts": ts})
+
+    if running is not None and records:
+        close(records[-1][0])
+    return events, worst
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert an RA3 RTOS trace dump to Chrome trace / Perfetto JSON")
+    parser.add_argument("dump", help="binary dump holding OS_TraceData")
+    parser.add_argument("-o", "--output", help="JSON file to write (default: stdout)")
+    arguments = parser.parse_args()
+
+    with open(arguments.dump, "rb") as file:
+        dump = file.read()
+
+    fields, offset = find_trace(dump)
+    if fields is None:
+        sys.exit("%s: no OS_TraceData found (is OS_TRACE_ENABLED set?)" % arguments.dump)
+
+    names, records, lost = read_records(dump, offset, fields)
+    events, worst = convert(names, records)
+
+    output = open(arguments.output, "w") if arguments.output else sys.stdout
+    json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, output)
+    if arguments.output:
+        output.close()
+
+    sys.stderr.write("%d records, %d overwritten\n" % (len(records), lost))
+    for task in sorted(worst):
+        sys.stderr.write("%-16s worst wake-up latency %.3f us\n" % (task_name(names, task), worst[task]))
+
+
+if __name__ == "__main__":
+    main()